@@ -2,10 +2,39 @@
 
 #include "Entity/ActorPool.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "Entity/PoolActor.h"
+#include "Saucewich.h"
 #include "SaucewichInstance.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Hits"), STAT_PoolHits, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Misses"), STAT_PoolMisses, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pool Evictions"), STAT_PoolEvictions, STATGROUP_Saucewich);
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice DumpPoolStats{
+	TEXT("Saucewich.Pool.Stats"),
+	TEXT("Prints hit/miss rates of the actor pool per class"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>&, UWorld* const World, FOutputDevice& Ar)
+	{
+		if (World && World->GetGameInstance<USaucewichInstance>())
+			AActorPool::Get(World)->DumpStats(Ar);
+	})
+};
+
+#if !UE_BUILD_SHIPPING
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice BenchmarkPool{
+	TEXT("Saucewich.Pool.Bench"),
+	TEXT("Compares the legacy weak pointer stack pool against the intrusive free-list. Usage: Saucewich.Pool.Bench [Iterations=10000]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* const World, FOutputDevice& Ar)
+	{
+		if (World && World->GetGameInstance<USaucewichInstance>())
+			AActorPool::Benchmark(World, Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000, Ar);
+	})
+};
+#endif
+
 const FActorSpawnParameters AActorPool::DefaultParameters;
+int32 AActorPool::NumClassIndices = 0;
 
 AActorPool* AActorPool::Get(const UObject* const WorldContextObject)
 {
@@ -26,23 +55,28 @@ APoolActor* AActorPool::Spawn(const TSubclassOf<APoolActor> Class, const FTransf
 {
 	check(Class);
 
-	if (const auto PoolPtr = Pool.Find(Class))
+	const auto Index = ResolvePoolIndex(Class);
+	auto& ClassPool = Pools[Index];
+
+	if (const auto Actor = Pop(ClassPool))
 	{
-		while (PoolPtr->Num() > 0)
-		{
-			if (const auto Actor = PoolPtr->Pop().Get())
-			{
-				Actor->SetOwner(SpawnParameters.Owner);
-				Actor->SetInstigator(SpawnParameters.Instigator);
-				Actor->SetActorTransform(Transform);
-				Actor->Activate();
-				return Actor;
-			}
-		}
+		++ClassPool.Stats.Hits;
+		INC_DWORD_STAT(STAT_PoolHits);
+
+		Actor->SetOwner(SpawnParameters.Owner);
+		Actor->SetInstigator(SpawnParameters.Instigator);
+		Actor->SetActorTransform(Transform);
+		Actor->Activate();
+		return Actor;
 	}
 
+	++ClassPool.Stats.Misses;
+	INC_DWORD_STAT(STAT_PoolMisses);
+
+	// SpawnActor 도중 다른 클래스의 풀이 추가되면 ClassPool이 무효화될 수 있으므로 더 이상 사용하지 않습니다.
 	if (const auto Actor = GetWorld()->SpawnActor<APoolActor>(Class, Transform, SpawnParameters))
 	{
+		Actor->PoolIndex = Index;
 		Actor->Activate();
 		return Actor;
 	}
@@ -50,9 +84,258 @@ APoolActor* AActorPool::Spawn(const TSubclassOf<APoolActor> Class, const FTransf
 	return nullptr;
 }
 
+int32 AActorPool::SpawnBatchInternal(const TSubclassOf<APoolActor> Class, const TArrayView<const FTransform> Transforms,
+	const FActorSpawnParameters& SpawnParameters, APoolActor** const OutActors)
+{
+	check(Class);
+
+	const auto Index = ResolvePoolIndex(Class);
+	const APoolActor* Leader = nullptr;
+	auto Num = 0, Hits = 0, Misses = 0;
+
+	for (auto&& Transform : Transforms)
+	{
+		auto Actor = Pop(Pools[Index]);
+		if (Actor)
+		{
+			++Hits;
+			Actor->SetOwner(SpawnParameters.Owner);
+			Actor->SetInstigator(SpawnParameters.Instigator);
+			Actor->SetActorTransform(Transform);
+		}
+		else
+		{
+			++Misses;
+			Actor = GetWorld()->SpawnActor<APoolActor>(Class, Transform, SpawnParameters);
+			if (!Actor) continue;
+			Actor->PoolIndex = Index;
+		}
+
+		Actor->BatchLeader = Leader;
+		Actor->Activate();
+		Actor->BatchLeader = nullptr;
+
+		if (!Leader) Leader = Actor;
+		OutActors[Num++] = Actor;
+	}
+
+	auto& ClassPool = Pools[Index];
+	ClassPool.Stats.Hits += Hits;
+	ClassPool.Stats.Misses += Misses;
+	INC_DWORD_STAT_BY(STAT_PoolHits, Hits);
+	INC_DWORD_STAT_BY(STAT_PoolMisses, Misses);
+
+	return Num;
+}
+
 void AActorPool::Release(APoolActor* const Actor)
 {
 	check(IsValidLowLevel());
-	const auto Class = Actor->GetClass();
-	Pool.FindOrAdd(Class).Add(Actor);
+
+	// 강제로 다시 반납되는 경우 이미 free-list에 들어 있을 수 있습니다.
+	if (Actor->OwningPool) return;
+
+	auto& ClassPool = GetClassPool(Actor);
+
+	if (ClassPool.HighWaterMark > 0 && ClassPool.NumFree >= ClassPool.HighWaterMark)
+	{
+		++ClassPool.Stats.Evictions;
+		INC_DWORD_STAT(STAT_PoolEvictions);
+		Actor->Destroy();
+		return;
+	}
+
+	Push(ClassPool, Actor);
+	ClassPool.Stats.Peak = FMath::Max(ClassPool.Stats.Peak, ClassPool.NumFree);
+}
+
+void AActorPool::Prewarm(const TSubclassOf<APoolActor> Class, const int32 Num)
+{
+	check(Class);
+
+	// 리플리케이트되는 액터는 서버에서 생성된 것만 의미가 있습니다.
+	if (IsNetMode(NM_Client) && GetDefault<AActor>(Class)->GetIsReplicated()) return;
+
+	const auto Index = ResolvePoolIndex(Class);
+	const auto HighWaterMark = Pools[Index].HighWaterMark;
+	const auto Target = HighWaterMark > 0 ? FMath::Min(Num, HighWaterMark) : Num;
+
+	while (Pools[Index].NumFree < Target)
+	{
+		const auto Actor = GetWorld()->SpawnActor<APoolActor>(Class);
+		if (!Actor) break;
+		Actor->PoolIndex = Index;
+		Actor->Release();
+	}
+}
+
+void AActorPool::SetHighWaterMark(const TSubclassOf<APoolActor> Class, const int32 HighWaterMark)
+{
+	check(Class);
+	Pools[ResolvePoolIndex(Class)].HighWaterMark = FMath::Max(HighWaterMark, 0);
+}
+
+void AActorPool::ApplyBudget(const FActorPoolBudget& Budget)
+{
+	const auto Class = Budget.Class.LoadSynchronous();
+	if (!Class) return;
+
+	SetHighWaterMark(Class, Budget.HighWaterMark);
+	Prewarm(Class, Budget.Prewarm);
 }
+
+const FActorPoolStats* AActorPool::GetStats(const TSubclassOf<APoolActor> Class) const
+{
+	const auto Index = GetDefault<APoolActor>(Class)->PoolIndex;
+	return Pools.IsValidIndex(Index) ? &Pools[Index].Stats : nullptr;
+}
+
+void AActorPool::DumpStats(FOutputDevice& Ar) const
+{
+	Ar.Logf(TEXT("%-48s %6s %6s %6s %8s %8s %7s %8s"), TEXT("Class"), TEXT("Free"), TEXT("Peak"), TEXT("HWM"), TEXT("Hits"), TEXT("Misses"), TEXT("Hit%"), TEXT("Evicted"));
+	for (auto&& ClassPool : Pools)
+	{
+		auto&& Stats = ClassPool.Stats;
+		const auto Total = Stats.Hits + Stats.Misses;
+		if (Total == 0 && ClassPool.NumFree == 0) continue;
+
+		Ar.Logf(TEXT("%-48s %6d %6d %6d %8u %8u %6.1f%% %8u"),
+			*GetNameSafe(ClassPool.Class.Get()), ClassPool.NumFree, Stats.Peak, ClassPool.HighWaterMark,
+			Stats.Hits, Stats.Misses, Total > 0 ? 100.f * Stats.Hits / Total : 0.f, Stats.Evictions
+		);
+	}
+
+	Ar.Logf(TEXT("Replicated pool actors: %d dormant, %d awake"), APoolActor::GetNumDormant(), APoolActor::GetNumAwake());
+}
+
+int32 AActorPool::GetNumPooled() const
+{
+	auto Num = 0;
+	for (auto&& ClassPool : Pools) Num += ClassPool.NumFree;
+	return Num;
+}
+
+void AActorPool::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	for (auto& ClassPool : Pools)
+		while (Pop(ClassPool)) {}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+int32 AActorPool::ResolvePoolIndex(UClass* const Class)
+{
+	const auto Def = GetDefault<APoolActor>(Class);
+	if (Def->PoolIndex == INDEX_NONE) Def->PoolIndex = NumClassIndices++;
+
+	const auto Index = Def->PoolIndex;
+	if (Index >= Pools.Num()) Pools.SetNum(Index + 1);
+
+	auto& ClassPool = Pools[Index];
+	if (!ClassPool.Class.IsValid()) ClassPool.Class = Class;
+	return Index;
+}
+
+AActorPool::FClassPool& AActorPool::GetClassPool(APoolActor* const Actor)
+{
+	if (!Pools.IsValidIndex(Actor->PoolIndex))
+		Actor->PoolIndex = ResolvePoolIndex(Actor->GetClass());
+
+	return Pools[Actor->PoolIndex];
+}
+
+void AActorPool::Push(FClassPool& ClassPool, APoolActor* const Actor)
+{
+	Actor->PrevFree = nullptr;
+	Actor->NextFree = ClassPool.Head;
+	if (ClassPool.Head) ClassPool.Head->PrevFree = Actor;
+	ClassPool.Head = Actor;
+
+	Actor->OwningPool = this;
+	++ClassPool.NumFree;
+}
+
+APoolActor* AActorPool::Pop(FClassPool& ClassPool)
+{
+	const auto Actor = ClassPool.Head;
+	if (Actor) Unlink(ClassPool, Actor);
+	return Actor;
+}
+
+void AActorPool::Unlink(FClassPool& ClassPool, APoolActor* const Actor)
+{
+	if (Actor->PrevFree) Actor->PrevFree->NextFree = Actor->NextFree;
+	else ClassPool.Head = Actor->NextFree;
+
+	if (Actor->NextFree) Actor->NextFree->PrevFree = Actor->PrevFree;
+
+	Actor->PrevFree = nullptr;
+	Actor->NextFree = nullptr;
+	Actor->OwningPool = nullptr;
+	--ClassPool.NumFree;
+}
+
+void AActorPool::Unlink(APoolActor* const Actor)
+{
+	check(Actor->OwningPool == this);
+	Unlink(Pools[Actor->PoolIndex], Actor);
+}
+
+#if !UE_BUILD_SHIPPING
+
+void AActorPool::Benchmark(UWorld* const World, const int32 Iterations, FOutputDevice& Ar)
+{
+	constexpr auto NumActors = 64;
+	constexpr auto Burst = 8;
+
+	const auto Pool = Get(World);
+	const TSubclassOf<APoolActor> Class = APoolActor::StaticClass();
+
+	TArray<APoolActor*> Actors;
+	for (auto i = 0; i < NumActors; ++i)
+		if (const auto Actor = World->SpawnActor<APoolActor>(Class))
+			Actors.Add(Actor);
+
+	APoolActor* Taken[Burst];
+
+	// 기존 방식: 매번 클래스로 TMap을 조회하고, 약한 포인터를 GUObjectArray를 통해 해석합니다.
+	TMap<TSubclassOf<APoolActor>, TArray<TWeakObjectPtr<APoolActor>>> Legacy;
+	for (const auto Actor : Actors) Legacy.FindOrAdd(Class).Add(Actor);
+
+	auto Start = FPlatformTime::Seconds();
+	for (auto i = 0; i < Iterations; ++i)
+	{
+		for (auto& Actor : Taken)
+		{
+			Actor = nullptr;
+			if (const auto Free = Legacy.Find(Class))
+				while (Free->Num() > 0)
+					if ((Actor = Free->Pop(false).Get()))
+						break;
+		}
+		for (const auto Actor : Taken)
+			Legacy.FindOrAdd(Class).Add(Actor);
+	}
+	const auto LegacyTime = FPlatformTime::Seconds() - Start;
+
+	FClassPool Intrusive;
+	for (const auto Actor : Actors) Pool->Push(Intrusive, Actor);
+
+	Start = FPlatformTime::Seconds();
+	for (auto i = 0; i < Iterations; ++i)
+	{
+		for (auto& Actor : Taken) Actor = Pool->Pop(Intrusive);
+		for (const auto Actor : Taken) Pool->Push(Intrusive, Actor);
+	}
+	const auto IntrusiveTime = FPlatformTime::Seconds() - Start;
+
+	while (Pool->Pop(Intrusive)) {}
+	for (const auto Actor : Actors) Actor->Destroy();
+
+	const auto NumOps = FMath::Max(Iterations * Burst * 2, 1);
+	Ar.Logf(TEXT("Actor pool churn: %d iterations x %d actors"), Iterations, Burst);
+	Ar.Logf(TEXT("  TMap + TWeakObjectPtr: %8.3f ms (%6.1f ns/op)"), LegacyTime * 1e3, LegacyTime * 1e9 / NumOps);
+	Ar.Logf(TEXT("  Intrusive free-list:   %8.3f ms (%6.1f ns/op)"), IntrusiveTime * 1e3, IntrusiveTime * 1e9 / NumOps);
+}
+
+#endif
@@ -7,15 +7,16 @@
 #include "Entity/PickupSpawner.h"
 #include "Player/TpsCharacter.h"
 #include "ShadowComponent.h"
-#include "GameMode/SaucewichGameState.h"
+#include "Saucewich.h"
 #include "Names.h"
 
 APickup::APickup()
 	:Collision{CreateDefaultSubobject<USphereComponent>(Names::Collision)},
 	Mesh{CreateDefaultSubobject<UStaticMeshComponent>(Names::Mesh)},
-	Shadow{CreateDefaultSubobject<UShadowComponent>(Names::Shadow)}
+	Shadow{Cosmetic::CreateSubobject<UShadowComponent>(this, Names::Shadow)}
 {
 	bReplicates = true;
+	bDilatable = true;
 	PrimaryActorTick.bCanEverTick = true;
 	
 	RootComponent = Collision;
@@ -30,21 +31,22 @@ APickup::APickup()
 	Mesh->BodyInstance.SetCollisionProfileNameDeferred(Names::NoCollision);
 	Mesh->SetGenerateOverlapEvents(true);
 	
-	Shadow->SetupAttachment(Mesh);
-	Shadow->SetRelativeScale3D(FVector{Collision->GetScaledSphereRadius() / 50.f});
+	if (Shadow)
+	{
+		Shadow->SetupAttachment(Mesh);
+		Shadow->SetRelativeScale3D(FVector{Collision->GetScaledSphereRadius() / 50.f});
+	}
 }
 
-void APickup::Freeze()
+void APickup::PostInitializeComponents()
 {
-	SetActorTickEnabled(false);
+	Super::PostInitializeComponents();
+	Cosmetic::Strip(this, Shadow);
 }
 
-void APickup::BeginPlay()
+void APickup::Freeze()
 {
-	Super::BeginPlay();
-	
-	const auto GS = CastChecked<ASaucewichGameState>(GetWorld()->GetGameState());
-	GS->AddDilatableActor(this);
+	SetActorTickEnabled(false);
 }
 
 void APickup::Tick(const float DeltaSeconds)
@@ -3,10 +3,23 @@
 #include "Entity/PoolActor.h"
 
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "Net/UnrealNetwork.h"
 
 #include "Entity/ActorPool.h"
 #include "GameMode/SaucewichGameState.h"
+#include "Saucewich.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dormant Pool Actors"), STAT_PoolDormant, STATGROUP_Saucewich);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Awake Pool Actors"), STAT_PoolAwake, STATGROUP_Saucewich);
+
+static TAutoConsoleVariable<int32> CVarDormancy{
+	TEXT("Saucewich.Pool.Dormancy"), 1,
+	TEXT("Replicated actors stop replicating (DORM_DormantAll) while they are parked in the actor pool")
+};
+
+int32 APoolActor::NumDormant = 0;
+int32 APoolActor::NumAwake = 0;
 
 void APoolActor::Release(const bool bForce)
 {
@@ -20,23 +33,30 @@ void APoolActor::Release(const bool bForce)
 	DetachFromActor(FDetachmentTransformRules::KeepRelativeTransform);
 	SetOwner(nullptr);
 	
-	Activation = EActivation::Released;
-
-	if (!bReplicates || HasAuthority())
-		AActorPool::Get(this)->Release(this);
+	SetActivation(EActivation::Released);
+	UTimeDilationSubsystem::Get(this)->Unregister(DilationHandle);
 	
 	OnReleased();
 	BP_OnReleased();
+
+	// 바뀐 상태는 휴면에 들어가기 전에 마저 리플리케이트됩니다.
+	SetDormant(true);
+
+	// 풀이 HighWaterMark를 넘어서 이 액터를 파괴할 수 있으므로 마지막에 반납합니다.
+	if (!bReplicates || HasAuthority())
+		AActorPool::Get(this)->Release(this);
 }
 
 void APoolActor::Activate(const bool bForce)
 {
 	if (IsActive() && !bForce) return;
+	SetDormant(false);
 	SetActorTickEnabled(true);
 	SetActorEnableCollision(true);
 	SetActorHiddenInGame(false);
 	SetLifeSpan(InitialLifeSpan);
-	Activation = EActivation::Activated;
+	SetActivation(EActivation::Activated);
+	if (bDilatable && !DilationHandle.IsValid()) DilationHandle = UTimeDilationSubsystem::Get(this)->Register(this);
 	OnActivated();
 	BP_OnActivated();
 }
@@ -45,16 +65,65 @@ void APoolActor::BeginPlay()
 {
 	Super::BeginPlay();
 	CastChecked<ASaucewichGameState>(GetWorld()->GetGameState())->OnCleanup.AddUObject(this, &APoolActor::Release, false);
+
+	if (bReplicates && HasAuthority() && !IsNetMode(NM_Standalone))
+	{
+		bCountDormancy = true;
+		++NumAwake;
+		SET_DWORD_STAT(STAT_PoolAwake, NumAwake);
+
+		// 미리 채워 둔 액터는 BeginPlay보다 먼저 반납되므로 그때 건너뛴 휴면을 여기서 시작합니다.
+		if (Activation == EActivation::Released) SetDormant(true);
+	}
+}
+
+void APoolActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (OwningPool) OwningPool->Unlink(this);
+	if (const auto Dilation = UTimeDilationSubsystem::Get(this)) Dilation->Unregister(DilationHandle);
+
+	if (bCountDormancy)
+	{
+		bCountDormancy = false;
+		if (NetDormancy == DORM_DormantAll) --NumDormant;
+		else --NumAwake;
+		SET_DWORD_STAT(STAT_PoolDormant, NumDormant);
+		SET_DWORD_STAT(STAT_PoolAwake, NumAwake);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void APoolActor::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(APoolActor, Activation);
+	DOREPLIFETIME(APoolActor, RepActivation);
 }
 
 void APoolActor::OnRep_Activation()
 {
-	if (IsActive()) Activate(true);
+	if (static_cast<EActivation>(RepActivation & 3) == EActivation::Activated) Activate(true);
 	else Release(true);
 }
+
+void APoolActor::SetActivation(const EActivation NewActivation)
+{
+	Activation = NewActivation;
+	if (!HasAuthority()) return;
+
+	auto Serial = RepActivation >> 2;
+	if (NewActivation == EActivation::Activated) ++Serial;
+	RepActivation = static_cast<uint8>(Serial << 2 | static_cast<uint8>(NewActivation));
+}
+
+void APoolActor::SetDormant(const bool bDormant)
+{
+	if (!bCountDormancy || bDormant == (NetDormancy == DORM_DormantAll)) return;
+	if (bDormant && !CVarDormancy.GetValueOnGameThread()) return;
+
+	SetNetDormancy(bDormant ? DORM_DormantAll : DORM_Awake);
+	NumDormant += bDormant ? 1 : -1;
+	NumAwake += bDormant ? -1 : 1;
+	SET_DWORD_STAT(STAT_PoolDormant, NumDormant);
+	SET_DWORD_STAT(STAT_PoolAwake, NumAwake);
+}
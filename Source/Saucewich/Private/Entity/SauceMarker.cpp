@@ -5,23 +5,69 @@
 #include "Components/InstancedStaticMeshComponent.h"
 #include "Engine/StaticMesh.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "GameFramework/GameStateBase.h"
 #include "Materials/MaterialInstanceDynamic.h"
 
 #include "GameMode/SaucewichGameMode.h"
 #include "GameMode/SaucewichGameState.h"
 #include "SaucewichInstance.h"
+#include "Saucewich.h"
 #include "Names.h"
 
+DECLARE_CYCLE_STAT(TEXT("Sauce Mark Flush"), STAT_SauceMarkFlush, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sauce Marks Queued"), STAT_SauceMarksQueued, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sauce Marks Accepted"), STAT_SauceMarksAccepted, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sauce Marks Rejected"), STAT_SauceMarksRejected, STATGROUP_Saucewich);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Sauce Mark Instances"), STAT_SauceMarkInstances, STATGROUP_Saucewich);
+
+static TAutoConsoleVariable<int32> CVarBudget{
+	TEXT("Saucewich.SauceMark.Budget"), 32,
+	TEXT("Maximum number of queued sauce marks validated per frame")
+};
+
+static TAutoConsoleVariable<int32> CVarMaxQueued{
+	TEXT("Saucewich.SauceMark.MaxQueued"), 256,
+	TEXT("Sauce marks beyond this many waiting in the queue are dropped")
+};
+
+static TAutoConsoleVariable<int32> CVarAsyncTraces{
+	TEXT("Saucewich.SauceMark.AsyncTraces"), 0,
+	TEXT("Validates sauce marks with async traces, adding them one frame later")
+};
+
+static TAutoConsoleVariable<int32> CVarCapacity{
+	TEXT("Saucewich.SauceMark.Capacity"), 0,
+	TEXT("Maximum number of sauce marks per team and material. Once full, the oldest mark is overwritten.\n")
+	TEXT("0: Unlimited"),
+	ECVF_Scalability
+};
+
+// 자국 격자 한 칸의 크기
+static constexpr auto GridCellSize = 200.f;
+
 UInstancedStaticMeshComponent* FSauceMarkers::PickRand() const
 {
 	return Comps[FMath::RandHelper(Comps.Num())];
 }
 
+ASauceMarker::ASauceMarker()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+}
+
 void ASauceMarker::Add(const uint8 Team, const float Scale, const FHitResult& Hit, const AActor* const Ignore)
 {
 #if !UE_SERVER
-	const auto World = Ignore->GetWorld();
+	const auto Marker = USaucewichInstance::Get(Ignore->GetWorld())->GetSauceMarker();
+	INC_DWORD_STAT(STAT_SauceMarksQueued);
+
+	if (!Marker->TeamMarkers.IsValidIndex(Team) || Marker->Pending.Num() >= CVarMaxQueued.GetValueOnGameThread())
+	{
+		INC_DWORD_STAT(STAT_SauceMarksRejected);
+		return;
+	}
 
 	auto Rot = Hit.ImpactNormal.ToOrientationQuat();
 	Rot *= FRotator{-90.f, 0.f, 0.f}.Quaternion();
@@ -30,48 +76,14 @@ void ASauceMarker::Add(const uint8 Team, const float Scale, const FHitResult& Hi
 	const auto RandScale = [&]{return Scale * FMath::RandRange(.85f, 1.15f);};
 	const FVector Scale3D{RandScale(), RandScale(), 1.f};
 
-	FCollisionQueryParams Params;
-	Params.AddIgnoredActor(Ignore);
+	auto& Request = Marker->Pending.AddDefaulted_GetRef();
+	Request.Transform = {Rot, Hit.ImpactPoint, Scale3D};
+	Request.ImpactPoint = Hit.ImpactPoint;
+	Request.ImpactNormal = Hit.ImpactNormal;
+	Request.Ignore = Ignore;
+	Request.Team = Team;
 
-	const auto LineTraceTest = [&](const float AxisScale, auto&&... Dirs)
-	{
-		for (auto&& Dir : {Forward<decltype(Dirs)>(Dirs)...})
-		{
-			const auto Offset = Rot.RotateVector(Dir) * (AxisScale * 50.f);
-			const auto Loc = Hit.ImpactPoint + Offset;
-			if (!World->LineTraceTestByChannel(Loc + Hit.ImpactNormal, Loc - Hit.ImpactNormal, ECC_Visibility, Params))
-				return false;
-		}
-		return true;
-	};
-
-	if (!LineTraceTest(Scale3D.X, FVector::ForwardVector, FVector::BackwardVector)) return;
-	if (!LineTraceTest(Scale3D.Y, FVector::RightVector, FVector::LeftVector)) return;
-
-	const auto GI = USaucewichInstance::Get(World);
-	const auto Marker = GI->GetSauceMarker();
-
-	TArray<FHitResult> Hits;
-	World->SweepMultiByChannel(
-		Hits,
-		Hit.ImpactPoint + Hit.ImpactNormal,
-		Hit.ImpactPoint - Hit.ImpactNormal,
-		Rot,
-		GI->GetDecalTraceChannel(),
-		FCollisionShape::MakeBox({Scale3D.X * 50.f, Scale3D.Y * 50.f, 0.f})
-	);
-	auto Offset = 0.f;
-	for (auto&& H : Hits)
-	{
-		if ((H.ImpactNormal | Hit.ImpactNormal) > .99f)
-		{
-			Offset = 1.f - H.Distance;
-			break;
-		}
-	}
-
-	const auto Comp = Marker->TeamMarkers[Team].PickRand();
-	Comp->AddInstanceWorldSpace({Rot, Hit.ImpactPoint + Hit.ImpactNormal * (Offset + .01f), Scale3D});
+	Marker->SetActorTickEnabled(true);
 #endif
 }
 
@@ -97,34 +109,39 @@ void ASauceMarker::Add(const AActor* const Owner, const uint8 Team, const FVecto
 
 void ASauceMarker::CleanupSauceMark(const UObject* const WorldContext, const FVector& Origin, const float Radius, const ECollisionChannel Channel)
 {
+#if !UE_SERVER
 	const auto World = WorldContext->GetWorld();
-	const auto Shape = FCollisionShape::MakeSphere(Radius);
-	
-	TArray<FHitResult> Hits;
-	if (!World->SweepMultiByChannel(Hits, Origin, Origin, FQuat::Identity, Channel, Shape)) return;
-	
+	const auto Marker = USaucewichInstance::Get(World)->GetSauceMarker();
+
+	// 자국 위치는 격자에 따로 보관하므로 자국 메시의 충돌을 검사하지 않습니다. Channel은 블루프린트 호환을 위해 남겨 둡니다.
+	const auto Min = GetCell(Origin - FVector{Radius});
+	const auto Max = GetCell(Origin + FVector{Radius});
+	const auto RadiusSq = FMath::Square(Radius);
+
 	TMap<UInstancedStaticMeshComponent*, TArray<int32>> Indices;
-	for (const auto& Hit : Hits)
+	for (auto X = Min.X; X <= Max.X; ++X)
+	for (auto Y = Min.Y; Y <= Max.Y; ++Y)
+	for (auto Z = Min.Z; Z <= Max.Z; ++Z)
 	{
-		const auto Comp = Cast<UInstancedStaticMeshComponent>(Hit.GetComponent());
-		if (Comp && !World->LineTraceTestByChannel(Origin, Hit.ImpactPoint, ECC_Visibility))
+		const auto Refs = Marker->Grid.Find({X, Y, Z});
+		if (!Refs) continue;
+
+		for (auto&& Ref : *Refs)
 		{
-			Indices.FindOrAdd(Comp).Add(Hit.Item);
+			const auto& Location = Marker->InstanceLocations.FindChecked(Ref.Comp)[Ref.Index];
+			if (FVector::DistSquared(Origin, Location) <= RadiusSq
+				&& !World->LineTraceTestByChannel(Origin, Location, ECC_Visibility))
+			{
+				Indices.FindOrAdd(Ref.Comp).Add(Ref.Index);
+			}
 		}
 	}
-	
+
 	for (auto& Pair : Indices)
-	{
-		const auto Comp = Pair.Key;
-		auto& Arr = Pair.Value;
-		Arr.Sort();
-		
-		for (auto i=0; i<Arr.Num(); ++i)
-		{
-			const auto bSucceeded = Comp->RemoveInstance(Arr[i] - i);
-			ensure(bSucceeded);
-		}
-	}
+		Marker->RemoveInstances(Pair.Key, Pair.Value);
+
+	if (Indices.Num() > 0) Marker->UpdateInstanceStat();
+#endif
 }
 
 void ASauceMarker::BeginPlay()
@@ -150,9 +167,312 @@ void ASauceMarker::BeginPlay()
 #endif 
 }
 
+void ASauceMarker::Tick(const float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+	SCOPE_CYCLE_COUNTER(STAT_SauceMarkFlush);
+
+	// 지난 프레임에 요청한 비동기 검사 결과를 먼저 처리합니다.
+	auto NumTracing = 0;
+	for (auto&& Request : Tracing)
+	{
+		bool bValid;
+		float Offset;
+		if (!QueryAsyncTraces(Request, bValid, Offset))
+		{
+			Tracing[NumTracing++] = Request;
+			continue;
+		}
+
+		if (bValid) Accept(Request, Offset);
+		else INC_DWORD_STAT(STAT_SauceMarksRejected);
+	}
+	Tracing.SetNum(NumTracing, false);
+
+	const auto bAsync = CVarAsyncTraces.GetValueOnGameThread() != 0;
+	const auto Num = FMath::Min(Pending.Num(), FMath::Max(CVarBudget.GetValueOnGameThread(), 1));
+	for (auto i = 0; i < Num; ++i)
+	{
+		auto& Request = Pending[i];
+		if (bAsync)
+		{
+			RequestAsyncTraces(Request);
+			Tracing.Add(Request);
+			continue;
+		}
+
+		float Offset;
+		if (Validate(Request, Offset)) Accept(Request, Offset);
+		else INC_DWORD_STAT(STAT_SauceMarksRejected);
+	}
+	Pending.RemoveAt(0, Num, false);
+
+	Commit();
+	SetActorTickEnabled(Pending.Num() > 0 || Tracing.Num() > 0);
+}
+
+template <class Fn>
+static bool ForEachCorner(const FSauceMarkRequest& Request, Fn&& Do)
+{
+	const auto Rot = Request.Transform.GetRotation();
+	const auto Scale = Request.Transform.GetScale3D() * 50.f;
+	const FVector Offsets[]{
+		Rot.RotateVector(FVector::ForwardVector) * Scale.X,
+		Rot.RotateVector(FVector::BackwardVector) * Scale.X,
+		Rot.RotateVector(FVector::RightVector) * Scale.Y,
+		Rot.RotateVector(FVector::LeftVector) * Scale.Y
+	};
+
+	for (auto i = 0; i < 4; ++i)
+	{
+		const auto Loc = Request.ImpactPoint + Offsets[i];
+		if (!Do(i, Loc + Request.ImpactNormal, Loc - Request.ImpactNormal))
+			return false;
+	}
+	return true;
+}
+
+static FCollisionQueryParams MakeParams(const FSauceMarkRequest& Request)
+{
+	FCollisionQueryParams Params{SCENE_QUERY_STAT(SauceMark)};
+	Params.AddIgnoredActor(Request.Ignore.Get());
+	return Params;
+}
+
+static FCollisionShape MakeShape(const FSauceMarkRequest& Request)
+{
+	const auto Scale = Request.Transform.GetScale3D() * 50.f;
+	return FCollisionShape::MakeBox({Scale.X, Scale.Y, 0.f});
+}
+
+static float GetOffset(const FSauceMarkRequest& Request, const TArray<FHitResult>& Hits)
+{
+	for (auto&& H : Hits)
+		if ((H.ImpactNormal | Request.ImpactNormal) > .99f)
+			return 1.f - H.Distance;
+
+	return 0.f;
+}
+
+bool ASauceMarker::Validate(const FSauceMarkRequest& Request, float& OutOffset) const
+{
+	const auto World = GetWorld();
+	const auto Params = MakeParams(Request);
+
+	if (!ForEachCorner(Request, [&](int32, const FVector& Start, const FVector& End)
+	{
+		return World->LineTraceTestByChannel(Start, End, ECC_Visibility, Params);
+	})) return false;
+
+	TArray<FHitResult> Hits;
+	World->SweepMultiByChannel(
+		Hits,
+		Request.ImpactPoint + Request.ImpactNormal,
+		Request.ImpactPoint - Request.ImpactNormal,
+		Request.Transform.GetRotation(),
+		USaucewichInstance::Get(this)->GetDecalTraceChannel(),
+		MakeShape(Request)
+	);
+
+	OutOffset = GetOffset(Request, Hits);
+	return true;
+}
+
+void ASauceMarker::RequestAsyncTraces(FSauceMarkRequest& Request) const
+{
+	const auto World = GetWorld();
+	const auto Params = MakeParams(Request);
+
+	ForEachCorner(Request, [&](const int32 i, const FVector& Start, const FVector& End)
+	{
+		Request.Traces[i] = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, ECC_Visibility, Params);
+		return true;
+	});
+
+	Request.Traces[4] = World->AsyncSweepByChannel(
+		EAsyncTraceType::Multi,
+		Request.ImpactPoint + Request.ImpactNormal,
+		Request.ImpactPoint - Request.ImpactNormal,
+		Request.Transform.GetRotation(),
+		USaucewichInstance::Get(this)->GetDecalTraceChannel(),
+		MakeShape(Request)
+	);
+}
+
+bool ASauceMarker::QueryAsyncTraces(const FSauceMarkRequest& Request, bool& bOutValid, float& OutOffset) const
+{
+	const auto World = GetWorld();
+
+	// 핸들이 만료되었다면 더 기다려도 결과를 받을 수 없으므로 버립니다.
+	for (auto&& Handle : Request.Traces)
+	{
+		if (!World->IsTraceHandleValid(Handle, false))
+		{
+			bOutValid = false;
+			return true;
+		}
+	}
+
+	FTraceDatum Datum;
+	for (auto i = 0; i < 4; ++i)
+	{
+		if (!World->QueryTraceData(Request.Traces[i], Datum)) return false;
+		if (Datum.OutHits.Num() == 0 || !Datum.OutHits[0].bBlockingHit)
+		{
+			bOutValid = false;
+			return true;
+		}
+	}
+
+	if (!World->QueryTraceData(Request.Traces[4], Datum)) return false;
+
+	bOutValid = true;
+	OutOffset = GetOffset(Request, Datum.OutHits);
+	return true;
+}
+
+void ASauceMarker::Accept(const FSauceMarkRequest& Request, const float Offset)
+{
+	INC_DWORD_STAT(STAT_SauceMarksAccepted);
+
+	auto Transform = Request.Transform;
+	Transform.SetLocation(Request.ImpactPoint + Request.ImpactNormal * (Offset + .01f));
+
+	const auto Comp = TeamMarkers[Request.Team].PickRand();
+	Batches.FindOrAdd(Comp).Add(Transform.GetRelativeTransform(Comp->GetComponentTransform()));
+}
+
+void ASauceMarker::Commit()
+{
+	// 컴포넌트마다 렌더 상태를 한 번만 갱신하도록 모아서 추가합니다.
+	const auto Capacity = CVarCapacity.GetValueOnGameThread();
+	auto bChanged = false;
+
+	for (auto& Pair : Batches)
+	{
+		const auto Comp = Pair.Key;
+		auto& Transforms = Pair.Value;
+		if (Transforms.Num() == 0) continue;
+		bChanged = true;
+
+		// 실행 중에 Capacity가 줄었다면 덮어쓰이지 않을 뒤쪽 자국을 지웁니다.
+		if (Capacity > 0 && Comp->GetInstanceCount() > Capacity)
+		{
+			TArray<int32> Excess;
+			for (auto Index = Capacity; Index < Comp->GetInstanceCount(); ++Index) Excess.Add(Index);
+			RemoveInstances(Comp, Excess);
+		}
+
+		const auto& ToWorld = Comp->GetComponentTransform();
+		const auto First = Comp->GetInstanceCount();
+		const auto NumAdd = Capacity <= 0 ? Transforms.Num() : FMath::Clamp(Capacity - First, 0, Transforms.Num());
+
+		if (NumAdd == Transforms.Num()) Comp->AddInstances(Transforms, false);
+		else if (NumAdd > 0) Comp->AddInstances(TArray<FTransform>{Transforms.GetData(), NumAdd}, false);
+
+		for (auto i = 0; i < NumAdd; ++i)
+			AddToGrid(Comp, First + i, ToWorld.TransformPosition(Transforms[i].GetLocation()));
+
+		// 자리가 없으면 가장 오래된 자국을 그 자리에서 덮어씁니다.
+		if (NumAdd < Transforms.Num())
+		{
+			auto& Cursor = RingCursors.FindOrAdd(Comp);
+			const auto Size = FMath::Min(Capacity, Comp->GetInstanceCount());
+			for (auto i = NumAdd; i < Transforms.Num(); ++i)
+			{
+				Cursor %= Size;
+				RemoveFromGrid(Comp, Cursor);
+				AddToGrid(Comp, Cursor, ToWorld.TransformPosition(Transforms[i].GetLocation()));
+				Comp->UpdateInstanceTransform(Cursor++, Transforms[i], false, i == Transforms.Num() - 1, true);
+			}
+		}
+
+		Transforms.Reset();
+	}
+
+	if (bChanged) UpdateInstanceStat();
+}
+
+FIntVector ASauceMarker::GetCell(const FVector& Location)
+{
+	return {
+		FMath::FloorToInt(Location.X / GridCellSize),
+		FMath::FloorToInt(Location.Y / GridCellSize),
+		FMath::FloorToInt(Location.Z / GridCellSize)
+	};
+}
+
+void ASauceMarker::AddToGrid(UInstancedStaticMeshComponent* const Comp, const int32 Index, const FVector& Location)
+{
+	auto& Locations = InstanceLocations.FindOrAdd(Comp);
+	if (Locations.Num() <= Index) Locations.SetNum(Index + 1, false);
+	Locations[Index] = Location;
+
+	Grid.FindOrAdd(GetCell(Location)).Add({Comp, Index});
+}
+
+void ASauceMarker::RemoveFromGrid(UInstancedStaticMeshComponent* const Comp, const int32 Index)
+{
+	const auto Cell = GetCell(InstanceLocations.FindChecked(Comp)[Index]);
+	auto& Refs = Grid.FindChecked(Cell);
+	Refs.RemoveSingleSwap({Comp, Index}, false);
+	if (Refs.Num() == 0) Grid.Remove(Cell);
+}
+
+void ASauceMarker::RemoveInstances(UInstancedStaticMeshComponent* const Comp, TArray<int32>& Indices)
+{
+	auto& Locations = InstanceLocations.FindChecked(Comp);
+	auto* const Cursor = RingCursors.Find(Comp);
+
+	// 큰 번호부터 지우면 맨 뒤에서 옮겨 오는 인스턴스는 항상 지우지 않을 인스턴스입니다.
+	Indices.Sort(TGreater<int32>{});
+	for (const auto Index : Indices)
+	{
+		RemoveFromGrid(Comp, Index);
+
+		const auto Last = Comp->GetInstanceCount() - 1;
+		if (Index != Last)
+		{
+			FTransform Transform;
+			Comp->GetInstanceTransform(Last, Transform);
+			Comp->UpdateInstanceTransform(Index, Transform, false, false, true);
+
+			RemoveFromGrid(Comp, Last);
+			AddToGrid(Comp, Index, Locations[Last]);
+		}
+
+		const auto bSucceeded = Comp->RemoveInstance(Last);
+		ensure(bSucceeded);
+		Locations.Pop(false);
+	}
+
+	if (Cursor && *Cursor >= Comp->GetInstanceCount()) *Cursor = 0;
+}
+
+void ASauceMarker::UpdateInstanceStat() const
+{
+#if STATS
+	auto Num = 0;
+	for (auto&& Markers : TeamMarkers)
+		for (const auto Comp : Markers.Comps)
+			Num += Comp->GetInstanceCount();
+
+	SET_DWORD_STAT(STAT_SauceMarkInstances, Num);
+#endif
+}
+
 void ASauceMarker::Cleanup()
 {
+	Pending.Reset();
+	Tracing.Reset();
+	Batches.Reset();
+	RingCursors.Reset();
+	InstanceLocations.Reset();
+	Grid.Reset();
+
 	for (auto&& Markers : TeamMarkers)
 		for (auto&& Comp : Markers.Comps)
 			Comp->ClearInstances();
+
+	UpdateInstanceStat();
 }
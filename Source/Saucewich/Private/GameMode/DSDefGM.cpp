@@ -2,6 +2,7 @@
 
 #include "GameMode/DSDefGM.h"
 #include "Engine/World.h"
+#include "GameMode/SaucewichBench.h"
 #include "GameMode/SaucewichGameMode.h"
 #include "SaucewichInstance.h"
 
@@ -18,6 +19,15 @@ ADSDefGM::ADSDefGM()
 void ADSDefGM::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// 벤치마크는 GameLift나 접속을 기다리지 않고 바로 게임을 시작합니다.
+	if (SaucewichBench::IsEnabled())
+	{
+		SaucewichBench::ApplySeed();
+		BeginStartGame();
+		return;
+	}
+
 	USaucewichInstance::Get(this)->StartupServer();
 }
 
@@ -0,0 +1,263 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#include "GameMode/SaucewichBench.h"
+
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "TimerManager.h"
+
+#include "Entity/ActorPool.h"
+#include "GameMode/SaucewichGameMode.h"
+#include "GameMode/SaucewichGameState.h"
+#include "Player/TpsCharacter.h"
+#include "Weapon/Projectile/ProjectileSubsystem.h"
+#include "Weapon/WeaponComponent.h"
+#include "Saucewich.h"
+
+namespace SaucewichBench
+{
+	static int32 ParseInt(const TCHAR* const Key, const int32 Default)
+	{
+		auto Value = Default;
+		FParse::Value(FCommandLine::Get(), Key, Value);
+		return Value;
+	}
+
+	bool IsEnabled()
+	{
+		static const auto bEnabled = FParse::Param(FCommandLine::Get(), TEXT("SaucewichBench"));
+		return bEnabled;
+	}
+
+	int32 GetNumBots(const int32 Default)
+	{
+		return ParseInt(TEXT("BenchBots="), Default);
+	}
+
+	int32 GetSeed()
+	{
+		static const auto Seed = ParseInt(TEXT("BenchSeed="), 0);
+		return Seed;
+	}
+
+	void ApplySeed()
+	{
+		FMath::RandInit(GetSeed());
+		FMath::SRandInit(GetSeed());
+	}
+
+	static volatile int32 NumTraces = 0;
+
+	void CountTraces(const int32 Num)
+	{
+		if (IsEnabled()) FPlatformAtomics::InterlockedAdd(&NumTraces, Num);
+	}
+
+	static int32 NumImpactRPCs = 0;
+
+	void CountImpactRPCs(const int32 Num)
+	{
+		if (IsEnabled()) NumImpactRPCs += Num;
+	}
+
+	static int32 NumInputMessages = 0;
+
+	void CountInputMessages(const int32 Num)
+	{
+		if (IsEnabled()) NumInputMessages += Num;
+	}
+
+	// 여러 맵에 걸쳐 기록하므로 월드가 아닌 프로세스 단위로 보관합니다.
+	// 줄은 만들어지는 대로 파일에 쓰므로 기록 시간이 길어도 메모리에 쌓이지 않습니다.
+	static TUniquePtr<FArchive> Csv;
+	static FString CsvPath;
+	static double StartTime = -1.0;
+	static bool bFinished = false;
+
+	static void WriteRow(const FString& Row)
+	{
+		if (!Csv) return;
+		const FTCHARToUTF8 Utf8{*Row};
+		Csv->Serialize(const_cast<ANSICHAR*>(Utf8.Get()), Utf8.Length());
+	}
+
+	static void Start()
+	{
+		if (!FParse::Value(FCommandLine::Get(), TEXT("BenchCsv="), CsvPath))
+			CsvPath = FPaths::ProfilingDir() / FString::Printf(TEXT("SaucewichBench-%s.csv"), *FDateTime::Now().ToString());
+
+		Csv.Reset(IFileManager::Get().CreateFileWriter(*CsvPath));
+		if (!Csv) UE_LOG(LogSaucewich, Error, TEXT("Failed to open benchmark file %s"), *CsvPath);
+
+		WriteRow(TEXT("Frame,Seconds,Map,MatchState,FrameMs,GameThreadMs,Characters,Projectiles,PooledActors,Traces,ImpactRPCs,InputMessages\n"));
+	}
+
+	static void Finish()
+	{
+		if (bFinished) return;
+		bFinished = true;
+
+		if (Csv)
+		{
+			const auto bSucceeded = Csv->Close();
+			Csv.Reset();
+
+			if (bSucceeded)
+				UE_LOG(LogSaucewich, Display, TEXT("Benchmark written to %s"), *IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*CsvPath));
+			else
+				UE_LOG(LogSaucewich, Error, TEXT("Failed to write benchmark to %s"), *CsvPath);
+		}
+
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+ABenchBot::ABenchBot()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	bWantsPlayerState = true;
+}
+
+void ABenchBot::Tick(const float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	const auto Character = GetPawn<ATpsCharacter>();
+	if (!Character || !Character->IsAlive())
+	{
+		Respawn();
+		return;
+	}
+
+	const auto Now = GetWorld()->GetTimeSeconds();
+	if (Now >= NextWanderTime)
+	{
+		WanderYaw = Random.FRandRange(-180.f, 180.f);
+		Strafe = Random.FRandRange(-1.f, 1.f);
+		NextWanderTime = Now + Random.FRandRange(1.f, 3.f);
+	}
+
+	// 보이는 적이 있으면 조준하며 다가가고, 없으면 돌아다닙니다. 발사는 자동 발사와 같이 GunTrace가 판단합니다.
+	auto Rotation = FRotator{0.f, WanderYaw, 0.f};
+	if (const auto Target = FindTarget(*Character))
+		Rotation = (Target->GetActorLocation() - Character->GetSpringArmLocation()).Rotation();
+
+	SetControlRotation(Rotation);
+	Character->AddMovementInput(FRotator{0.f, Rotation.Yaw, 0.f}.Vector());
+	Character->AddMovementInput(FRotationMatrix{Rotation}.GetScaledAxis(EAxis::Y), Strafe);
+
+	const auto WeaponComponent = Character->GetWeaponComponent();
+	FHitResult Hit;
+	if (WeaponComponent->GunTrace(Hit)) WeaponComponent->FireP();
+	else WeaponComponent->FireR();
+}
+
+ATpsCharacter* ABenchBot::FindTarget(const ATpsCharacter& Self) const
+{
+	const auto GS = GetWorld()->GetGameState<ASaucewichGameState>();
+	if (!GS) return nullptr;
+
+	const auto Start = Self.GetActorLocation();
+	ATpsCharacter* Nearest = nullptr;
+	auto NearestDistSq = MAX_flt;
+
+	for (auto Team = 0; Team < GS->GetNumTeams(); ++Team)
+	{
+		if (Team == Self.GetTeam()) continue;
+		for (const auto Character : GS->GetTeamCharacters(Team))
+		{
+			if (!Character->IsAlive()) continue;
+			const auto DistSq = FVector::DistSquared(Start, Character->GetActorLocation());
+			if (DistSq < NearestDistSq)
+			{
+				Nearest = Character;
+				NearestDistSq = DistSq;
+			}
+		}
+	}
+
+	return Nearest;
+}
+
+void ABenchBot::Respawn()
+{
+	auto&& TimerManager = GetWorldTimerManager();
+	if (TimerManager.IsTimerActive(RespawnTimer)) return;
+
+	const auto GameMode = GetWorld()->GetAuthGameMode<ASaucewichGameMode>();
+	if (!GameMode || !GameMode->IsMatchInProgress()) return;
+
+	TimerManager.SetTimer(RespawnTimer, FTimerDelegate::CreateWeakLambda(this, [this]
+	{
+		const auto Character = GetPawn<ATpsCharacter>();
+		if (Character && Character->IsAlive()) return;
+
+		if (const auto Gm = GetWorld()->GetAuthGameMode<ASaucewichGameMode>())
+			Gm->RestartPlayer(this);
+	}), FMath::Max(GameMode->GetRespawnDelay(), .1f), false);
+}
+
+bool UBenchRecorder::ShouldCreateSubsystem(UObject* const Outer) const
+{
+	return SaucewichBench::IsEnabled() && Super::ShouldCreateSubsystem(Outer);
+}
+
+void UBenchRecorder::Deinitialize()
+{
+	// 기록 도중에 게임이 끝나도 지금까지의 결과는 남깁니다.
+	if (IsEngineExitRequested()) SaucewichBench::Finish();
+	Super::Deinitialize();
+}
+
+void UBenchRecorder::Tick(const float DeltaTime)
+{
+	using namespace SaucewichBench;
+
+	const auto World = GetWorld();
+	const auto Now = FPlatformTime::Seconds();
+
+	if (StartTime < 0.0)
+	{
+		StartTime = Now;
+		Start();
+	}
+
+	const auto GS = World->GetGameState<ASaucewichGameState>();
+	auto NumCharacters = 0;
+	for (auto Team = 0; GS && Team < GS->GetNumTeams(); ++Team)
+		NumCharacters += GS->GetTeamCharacters(Team).Num();
+
+	WriteRow(FString::Printf(TEXT("%llu,%.3f,%s,%s,%.3f,%.3f,%d,%d,%d,%d,%d,%d\n"),
+		static_cast<uint64>(GFrameCounter),
+		Now - StartTime,
+		*World->GetMapName(),
+		GS ? *GS->GetMatchState().ToString() : TEXT(""),
+		DeltaTime * 1000.f,
+		FPlatformTime::ToMilliseconds(GGameThreadTime),
+		NumCharacters,
+		UProjectileSubsystem::Get(World)->GetNum(),
+		AActorPool::Get(World)->GetNumPooled(),
+		FPlatformAtomics::InterlockedExchange(&NumTraces, 0),
+		NumImpactRPCs,
+		NumInputMessages
+	));
+	NumImpactRPCs = 0;
+	NumInputMessages = 0;
+
+	if (Now - StartTime >= ParseInt(TEXT("BenchSeconds="), 120))
+		Finish();
+}
+
+bool UBenchRecorder::IsTickable() const
+{
+	if (HasAnyFlags(RF_ClassDefaultObject) || SaucewichBench::bFinished) return false;
+	const auto World = GetWorld();
+	return World && World->GetAuthGameMode<ASaucewichGameMode>() != nullptr;
+}
+
+TStatId UBenchRecorder::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UBenchRecorder, STATGROUP_Tickables);
+}
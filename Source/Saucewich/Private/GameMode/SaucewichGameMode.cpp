@@ -15,6 +15,7 @@
 #include "TimerManager.h"
 
 #include "Entity/PickupSpawner.h"
+#include "GameMode/SaucewichBench.h"
 #include "GameMode/SaucewichGameState.h"
 #include "Player/SaucewichPlayerController.h"
 #include "Player/SaucewichPlayerState.h"
@@ -136,6 +137,30 @@ void ASaucewichGameMode::BeginPlay()
 	}
 
 	USaucewichInstance::Get(this)->OnGameReady();
+
+	if (SaucewichBench::IsEnabled())
+	{
+		SaucewichBench::ApplySeed();
+		SpawnBenchBots();
+	}
+}
+
+void ASaucewichGameMode::SpawnBenchBots()
+{
+	// 봇은 매치가 시작되어 캐릭터가 모두 죽은 뒤 스스로 부활합니다.
+	const auto Num = SaucewichBench::GetNumBots(Data.MaxPlayers);
+	for (auto i = 0; i < Num; ++i)
+	{
+		FActorSpawnParameters Parameters;
+		Parameters.ObjectFlags |= RF_Transient;
+
+		const auto Bot = GetWorld()->SpawnActor<ABenchBot>(Parameters);
+		Bot->SetSeed(SaucewichBench::GetSeed() + i);
+		++NumBots;
+
+		ChangeName(Bot, FString::Printf(TEXT("Bot%d"), i), false);
+		GenericPlayerInitialization(Bot);
+	}
 }
 
 void ASaucewichGameMode::PreLogin(const FString& Options, const FString& Address, const FUniqueNetIdRepl& UniqueId, FString& ErrorMessage)
@@ -354,7 +379,7 @@ void ASaucewichGameMode::SetPlayerDefaults(APawn* const PlayerPawn)
 
 bool ASaucewichGameMode::ReadyToStartMatch_Implementation()
 {
-	return NumPlayers >= Data.MinPlayerToStart;
+	return NumPlayers + NumBots >= Data.MinPlayerToStart;
 }
 
 bool ASaucewichGameMode::ReadyToEndMatch_Implementation()
@@ -400,7 +425,7 @@ void ASaucewichGameMode::EndMatch()
 
 bool ASaucewichGameMode::EndMatchIfNoPlayers()
 {
-	if (NumPlayers == 0 && IsNetMode(NM_DedicatedServer))
+	if (NumPlayers + NumBots == 0 && IsNetMode(NM_DedicatedServer))
 	{
 #if WITH_GAMELIFT
 		if (bTerminating)
@@ -2,42 +2,113 @@
 
 #include "GameMode/SaucewichGameState.h"
 
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
-#include "Particles/ParticleSystemComponent.h"
 #include "TimerManager.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
+#include "Entity/ActorPool.h"
+#include "GameMode/SaucewichBench.h"
 #include "Player/SaucewichPlayerState.h"
 #include "Player/TpsCharacter.h"
 #include "GameMode/SaucewichGameMode.h"
+#include "GameMode/TimeDilationSubsystem.h"
+#include "Weapon/Gun.h"
+#include "Weapon/Projectile/Projectile.h"
+#include "SaucewichInstance.h"
+#include "Saucewich.h"
 
-template <class Fn>
-void ForEachEveryPlayer(const TArray<APlayerState*>& PlayerArray, Fn&& Do)
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectile Impacts Sent"), STAT_ImpactsSent, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectile Impact RPCs"), STAT_ImpactRPCs, STATGROUP_Saucewich);
+
+static TAutoConsoleVariable<int32> CVarMaxImpactsPerRPC{
+	TEXT("Saucewich.Net.MaxImpactsPerRPC"), 32,
+	TEXT("Maximum number of projectile impacts sent in one batched multicast")
+};
+
+TArray<ASaucewichPlayerState*> ASaucewichGameState::GetPlayersByTeam(const uint8 Team) const
 {
-	for (const auto PS : PlayerArray)
-		Do(CastChecked<ASaucewichPlayerState>(PS));
+	return TeamRegistry.IsValidIndex(Team) ? TeamRegistry[Team].Players : TArray<ASaucewichPlayerState*>{};
 }
 
-template <class Fn>
-void ForEachPlayer(const TArray<APlayerState*>& PlayerArray, const uint8 Team, Fn&& Do)
+TArray<ATpsCharacter*> ASaucewichGameState::GetCharactersByTeam(const uint8 Team) const
 {
-	ForEachEveryPlayer(PlayerArray, [Team, &Do](const auto P){if (P->GetTeam() == Team) Do(P);});
+	return TeamRegistry.IsValidIndex(Team) ? TeamRegistry[Team].Characters : TArray<ATpsCharacter*>{};
 }
 
-TArray<ASaucewichPlayerState*> ASaucewichGameState::GetPlayersByTeam(const uint8 Team) const
+TArrayView<ASaucewichPlayerState* const> ASaucewichGameState::GetTeamPlayers(const uint8 Team) const
 {
-	TArray<ASaucewichPlayerState*> Players;
-	ForEachPlayer(PlayerArray, Team, [&Players](const auto P){Players.Add(P);});
-	return Players;
+	if (!TeamRegistry.IsValidIndex(Team)) return {};
+	return TeamRegistry[Team].Players;
 }
 
-TArray<ATpsCharacter*> ASaucewichGameState::GetCharactersByTeam(const uint8 Team) const
+TArrayView<ATpsCharacter* const> ASaucewichGameState::GetTeamCharacters(const uint8 Team) const
+{
+	if (!TeamRegistry.IsValidIndex(Team)) return {};
+	return TeamRegistry[Team].Characters;
+}
+
+const FCollisionQueryParams& ASaucewichGameState::GetTeamIgnoreParams(const uint8 Team) const
+{
+	return TeamRegistry.IsValidIndex(Team) ? TeamRegistry[Team].IgnoreParams : FCollisionQueryParams::DefaultQueryParam;
+}
+
+void ASaucewichGameState::UpdatePlayerTeam(ASaucewichPlayerState* const Player)
+{
+	for (auto& Registry : TeamRegistry) Registry.Players.RemoveSingleSwap(Player, false);
+
+	// 클라이언트에서는 PlayerArray에 추가되기 전에 팀이 먼저 복제될 수 있습니다. 이 경우 AddPlayerState에서 추가됩니다.
+	if (Player->IsValidTeam() && PlayerArray.Contains(Player))
+		GetTeamRegistry(Player->GetTeam()).Players.Add(Player);
+}
+
+void ASaucewichGameState::UpdateCharacterTeam(ATpsCharacter* const Character)
+{
+	for (auto& Registry : TeamRegistry) Registry.Characters.RemoveSingleSwap(Character, false);
+
+	const auto Player = Character->GetPlayerState<ASaucewichPlayerState>();
+	if (Player && Player->IsValidTeam())
+		GetTeamRegistry(Player->GetTeam()).Characters.Add(Character);
+
+	UpdateIgnoreParams();
+}
+
+void ASaucewichGameState::RemoveCharacter(ATpsCharacter* const Character)
 {
-	TArray<ATpsCharacter*> Characters;
-	ForEachPlayer(PlayerArray, Team, [&](ASaucewichPlayerState* const P) {
-		if (const auto C = P->GetPawn<ATpsCharacter>()) Characters.Add(C);
-	});
-	return Characters;
+	for (auto& Registry : TeamRegistry) Registry.Characters.RemoveSingleSwap(Character, false);
+	UpdateIgnoreParams();
+}
+
+void ASaucewichGameState::AddPlayerState(APlayerState* const PlayerState)
+{
+	Super::AddPlayerState(PlayerState);
+	UpdatePlayerTeam(CastChecked<ASaucewichPlayerState>(PlayerState));
+}
+
+void ASaucewichGameState::RemovePlayerState(APlayerState* const PlayerState)
+{
+	Super::RemovePlayerState(PlayerState);
+
+	const auto Player = CastChecked<ASaucewichPlayerState>(PlayerState);
+	for (auto& Registry : TeamRegistry) Registry.Players.RemoveSingleSwap(Player, false);
+	if (const auto Character = Player->GetPawn<ATpsCharacter>()) RemoveCharacter(Character);
+}
+
+ASaucewichGameState::FTeamRegistry& ASaucewichGameState::GetTeamRegistry(const uint8 Team)
+{
+	if (!TeamRegistry.IsValidIndex(Team)) TeamRegistry.SetNum(Team + 1);
+	return TeamRegistry[Team];
+}
+
+void ASaucewichGameState::UpdateIgnoreParams()
+{
+	for (auto& Registry : TeamRegistry)
+	{
+		Registry.IgnoreParams.ClearIgnoredActors();
+		for (const auto Character : Registry.Characters)
+			Registry.IgnoreParams.AddIgnoredActor(Character);
+	}
 }
 
 ASaucewichGameState::ASaucewichGameState()
@@ -49,10 +120,7 @@ uint8 ASaucewichGameState::GetMinPlayerTeam() const
 {
 	TArray<uint8> Num;
 	Num.AddZeroed(GetGmData().Teams.Num());
-	ForEachEveryPlayer(PlayerArray, [&](ASaucewichPlayerState* P)
-	{
-		if (P->IsValidTeam()) ++Num[P->GetTeam()];
-	});
+	for (auto i = 0; i < Num.Num(); ++i) Num[i] = GetNumPlayers(i);
 	
 	TArray<uint8> Min{0};
 	for (auto i = 1; i < Num.Num(); ++i)
@@ -87,6 +155,7 @@ void ASaucewichGameState::SetTeamScore(const uint8 Team, const int32 NewScore)
 	GameMode->PrintMessage(Msg, EMsgType::Center);
 	
 	TeamScore[Team] = NewScore;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASaucewichGameState, TeamScore, this);
 }
 
 bool ASaucewichGameState::CanAddPersonalScore() const
@@ -108,22 +177,66 @@ void ASaucewichGameState::BeginPlay()
 {
 	Super::BeginPlay();
 	TeamScore.AddZeroed(GetGmData().Teams.Num());
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASaucewichGameState, TeamScore, this);
 	TeamScoreAddMsgFmt = GetGmData().TeamScoreAddMsg;
+	PrewarmActorPool();
 }
 
 void ASaucewichGameState::Tick(const float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+
+	if (PendingImpacts.Num() > 0) FlushImpacts();
 	
 	if (Dilation > KINDA_SMALL_NUMBER)
 	{
 		const auto Duration = GetGmData().MatchEndingTime;
 		Dilation = FMath::Max(Dilation - DeltaTime / Duration, KINDA_SMALL_NUMBER);
-		for (const auto Actor : DilatableActors) if (IsValid(Actor)) Actor->CustomTimeDilation = Dilation;
-		for (const auto PSC : DilatablePSCs) if (IsValid(PSC)) PSC->CustomTimeDilation = Dilation;
+		const auto Subsystem = UTimeDilationSubsystem::Get(this);
+		Subsystem->SetScale(EDilationGroup::Gameplay, Dilation);
+		Subsystem->SetScale(EDilationGroup::Effects, Dilation);
 	}
 }
 
+void ASaucewichGameState::AddImpact(AProjectile* const Projectile, const FHitResult& Hit, const uint8 Team)
+{
+	auto& Impact = PendingImpacts.AddDefaulted_GetRef();
+	Impact.Projectile = Projectile;
+	Impact.Class = Projectile->GetClass();
+	Impact.Location = Hit.ImpactPoint;
+	Impact.Normal = Hit.ImpactNormal;
+	Impact.Team = Team;
+	Impact.Serial = Projectile->GetActivationSerial();
+}
+
+void ASaucewichGameState::FlushImpacts()
+{
+	const auto MaxPerRPC = FMath::Max(CVarMaxImpactsPerRPC.GetValueOnGameThread(), 1);
+	const auto Num = PendingImpacts.Num();
+
+	TArray<FProjectileImpact> Batch;
+	for (auto First = 0; First < Num; First += MaxPerRPC)
+	{
+		Batch.Reset();
+		Batch.Append(PendingImpacts.GetData() + First, FMath::Min(MaxPerRPC, Num - First));
+		MulticastImpacts(Batch);
+		INC_DWORD_STAT(STAT_ImpactRPCs);
+		SaucewichBench::CountImpactRPCs();
+	}
+
+	INC_DWORD_STAT_BY(STAT_ImpactsSent, Num);
+	PendingImpacts.Reset();
+}
+
+void ASaucewichGameState::MulticastImpacts_Implementation(const TArray<FProjectileImpact>& Impacts)
+{
+	// 서버는 AddImpact를 부를 때 이미 폭발을 처리했습니다.
+	if (HasAuthority()) return;
+
+	for (auto&& Impact : Impacts)
+		AProjectile::ReceiveImpact(this, Impact);
+}
+
 void ASaucewichGameState::HandleMatchHasStarted()
 {
 	Super::HandleMatchHasStarted();
@@ -152,10 +265,8 @@ void ASaucewichGameState::HandleMatchHasEnded()
 		
 		if (WonTeam != uint8(-1))
 		{
-			ForEachPlayer(PlayerArray, WonTeam, [](ASaucewichPlayerState* const Player)
-			{
+			for (const auto Player : GetTeamPlayers(WonTeam))
 				Player->AddScore(TEXT("Win"), 0, true);
-			});
 
 			UE_LOG(LogGameState, Log, TEXT("Match result: The [%d] %s team won the game!"),
 			       static_cast<int>(WonTeam), *GetGmData().Teams[WonTeam].Name.ToString());
@@ -177,8 +288,11 @@ void ASaucewichGameState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>&
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 	DOREPLIFETIME(ASaucewichGameState, RoundStartTime);
-	DOREPLIFETIME(ASaucewichGameState, TeamScore);
 	DOREPLIFETIME(ASaucewichGameState, WonTeam);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASaucewichGameState, TeamScore, Params);
 }
 
 void ASaucewichGameState::HandleMatchEnding()
@@ -208,9 +322,33 @@ void ASaucewichGameState::MulticastPlayerDeath_Implementation(
 
 uint8 ASaucewichGameState::GetNumPlayers(const uint8 Team) const
 {
-	uint8 Num = 0;
-	ForEachPlayer(PlayerArray, Team, [&Num](auto){++Num;});
-	return Num;
+	return GetTeamPlayers(Team).Num();
+}
+
+const FAutoAimSnapshot& ASaucewichGameState::GetAutoAimSnapshot(const uint8 Team) const
+{
+	if (AutoAimSnapshotFrame != GFrameCounter || AutoAimSnapshots.Num() == 0)
+	{
+		AutoAimSnapshotFrame = GFrameCounter;
+		AutoAimSnapshots.SetNum(GetNumTeams());
+		for (auto& Snapshot : AutoAimSnapshots) Snapshot.Reset();
+
+		for (auto i = 0; i < AutoAimSnapshots.Num(); ++i)
+		{
+			for (const auto Character : GetTeamCharacters(i))
+				if (Character->IsAlive()) AutoAimSnapshots[i].Add(Character);
+
+			AutoAimSnapshots[i].Pad();
+		}
+	}
+
+	check(AutoAimSnapshots.IsValidIndex(Team));
+	return AutoAimSnapshots[Team];
+}
+
+int32 ASaucewichGameState::GetNumTeams() const
+{
+	return GetGmData().Teams.Num();
 }
 
 uint8 ASaucewichGameState::GetWinningTeam() const
@@ -237,13 +375,7 @@ uint8 ASaucewichGameState::GetWinningTeam() const
 
 uint8 ASaucewichGameState::GetEmptyTeam() const
 {
-	auto T0 = 0, T1 = 0;
-	ForEachEveryPlayer(PlayerArray, [&T0, &T1](ASaucewichPlayerState* const Ply)
-	{
-		const auto T = Ply->GetTeam();
-		if (T == 0) ++T0;
-		else if (T == 1) ++T1;
-	});
+	const auto T0 = GetNumPlayers(0), T1 = GetNumPlayers(1);
 	if (T0 == 0 && T1 > 0) return 0;
 	if (T0 > 0 && T1 == 0) return 1;
 
@@ -255,6 +387,44 @@ const FGameData& ASaucewichGameState::GetGmData() const
 	return CastChecked<ASaucewichGameMode>(GetDefaultGameMode())->GetData();
 }
 
+void ASaucewichGameState::PrewarmActorPool() const
+{
+	const auto GI = USaucewichInstance::Get(this);
+	const auto Pool = AActorPool::Get(GI);
+
+	TSet<UClass*> Overridden;
+	for (auto&& Budget : GI->GetPoolBudgets())
+	{
+		Pool->ApplyBudget(Budget);
+		Overridden.Add(Budget.Class.Get());
+	}
+
+	// 발사체 클래스마다 가장 많이 필요한 총을 기준으로, 모든 플레이어가 그 총을 쏘는 상황에 대비합니다.
+	TMap<UClass*, int32> PerPlayer;
+	for (auto&& Weapons : {&GI->GetPrimaryWeapons(), &GI->GetSecondaryWeapons()})
+	{
+		for (auto&& Weapon : *Weapons)
+		{
+			const auto Cls = Weapon.LoadSynchronous();
+			if (!Cls || !Cls->IsChildOf<AGun>()) continue;
+
+			const auto ProjCls = AGun::GetGunDataFromClass(Cls).ProjectileClass.Get();
+			if (!ProjCls || Overridden.Contains(ProjCls)) continue;
+
+			auto& Num = PerPlayer.FindOrAdd(ProjCls);
+			Num = FMath::Max(Num, AGun::EstimateLiveProjectiles(Cls));
+		}
+	}
+
+	const auto NumPlayers = GetGmData().MaxPlayers;
+	for (auto&& Pair : PerPlayer)
+	{
+		const auto Prewarm = Pair.Value * NumPlayers;
+		Pool->SetHighWaterMark(Pair.Key, Prewarm * 2);
+		Pool->Prewarm(Pair.Key, Prewarm);
+	}
+}
+
 void ASaucewichGameState::OnRep_WonTeam() const
 {
 	OnMatchEnd.Broadcast(WonTeam);
@@ -0,0 +1,222 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#include "GameMode/TimeDilationSubsystem.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Particles/ParticleSystemComponent.h"
+
+#include "Saucewich.h"
+
+DECLARE_CYCLE_STAT(TEXT("Time Dilation"), STAT_TimeDilation, STATGROUP_Saucewich);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dilation Entries"), STAT_DilationEntries, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dilation Writes"), STAT_DilationWrites, STATGROUP_Saucewich);
+
+static TAutoConsoleVariable<int32> CVarSweepBudget{
+	TEXT("Saucewich.Dilation.SweepBudget"), 32,
+	TEXT("Number of dilation entries checked per group each frame to compact destroyed actors")
+};
+
+static TAutoConsoleVariable<float> CVarMinStep{
+	TEXT("Saucewich.Dilation.MinStep"), .01f,
+	TEXT("Smallest change of a group scale that is written to its members. Reaching 1 or near 0 is always written.")
+};
+
+UTimeDilationSubsystem* UTimeDilationSubsystem::Get(const UObject* const WorldContextObject)
+{
+	return WorldContextObject->GetWorld()->GetSubsystem<UTimeDilationSubsystem>();
+}
+
+FDilationHandle UTimeDilationSubsystem::Register(AActor* const Actor, const EDilationGroup Group)
+{
+	if (!Actor) return {};
+
+	FEntry Entry;
+	Entry.Actor = Actor;
+	return Add(Group, Entry);
+}
+
+FDilationHandle UTimeDilationSubsystem::Register(UParticleSystemComponent* const PSC, const EDilationGroup Group)
+{
+	if (!PSC) return {};
+
+	FEntry Entry;
+	Entry.PSC = PSC;
+	PSC->OnSystemFinished.AddUniqueDynamic(this, &UTimeDilationSubsystem::OnSystemFinished);
+	return Add(Group, Entry);
+}
+
+void UTimeDilationSubsystem::Unregister(FDilationHandle& Handle)
+{
+	if (!Handle.IsValid()) return;
+
+	auto&& Group = Groups[static_cast<int32>(Handle.Group)];
+	// 풀 액터가 반납될 때마다 불리므로 빈자리는 그대로 두고 Sweep에서 줄입니다.
+	if (Group.Entries.IsValidIndex(Handle.Index) && Group.Entries[Handle.Index].Serial == Handle.Serial)
+		Remove(Group, Handle.Index, true);
+
+	Handle = {};
+}
+
+void UTimeDilationSubsystem::SetScale(const EDilationGroup Group, const float Scale)
+{
+	Groups[static_cast<int32>(Group)].Scale = Scale;
+}
+
+void UTimeDilationSubsystem::Deinitialize()
+{
+	for (auto&& Group : Groups) Group.Entries.Empty();
+	NumEntries = 0;
+	SET_DWORD_STAT(STAT_DilationEntries, 0);
+	Super::Deinitialize();
+}
+
+void UTimeDilationSubsystem::Tick(float)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TimeDilation);
+
+	const auto MinStep = CVarMinStep.GetValueOnGameThread();
+	const auto Budget = CVarSweepBudget.GetValueOnGameThread();
+
+	for (auto&& Group : Groups)
+	{
+		// 배율이 조금씩 바뀌는 동안에는 MinStep 단위로 모아서 씁니다.
+		const auto Delta = FMath::Abs(Group.Scale - Group.AppliedScale);
+		if (Delta > 0.f && (Delta >= MinStep || Group.Scale <= MinStep || Group.Scale >= 1.f))
+		{
+			Group.AppliedScale = Group.Scale;
+			Apply(Group);
+		}
+		else
+		{
+			Sweep(Group, Budget);
+		}
+	}
+}
+
+bool UTimeDilationSubsystem::IsTickable() const
+{
+	if (HasAnyFlags(RF_ClassDefaultObject)) return false;
+	if (NumEntries > 0) return true;
+
+	// 비어 있어도 나중에 등록되는 것이 바뀐 배율을 받도록 AppliedScale은 따라가야 합니다.
+	for (auto&& Group : Groups)
+		if (Group.Scale != Group.AppliedScale) return true;
+
+	return false;
+}
+
+TStatId UTimeDilationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTimeDilationSubsystem, STATGROUP_Tickables);
+}
+
+FDilationHandle UTimeDilationSubsystem::Add(const EDilationGroup Group, const FEntry& Entry)
+{
+	auto&& G = Groups[static_cast<int32>(Group)];
+
+	FDilationHandle Handle;
+	Handle.Group = Group;
+	Handle.Serial = ++NextSerial;
+	Handle.Index = G.Entries.Add(Entry);
+	G.Entries[Handle.Index].Serial = Handle.Serial;
+
+	if (const auto Actor = Entry.Actor.Get()) Actor->CustomTimeDilation = G.AppliedScale;
+	if (const auto PSC = Entry.PSC.Get()) PSC->CustomTimeDilation = G.AppliedScale;
+
+	++NumEntries;
+	SET_DWORD_STAT(STAT_DilationEntries, NumEntries);
+	return Handle;
+}
+
+void UTimeDilationSubsystem::Remove(FGroup& Group, const int32 Index, const bool bRestore)
+{
+	auto&& Entry = Group.Entries[Index];
+
+	if (const auto Actor = Entry.Actor.Get())
+	{
+		if (bRestore) Actor->CustomTimeDilation = 1.f;
+	}
+
+	// 풀에서 재사용되는 파티클이므로 다음에 쓰일 때를 위해 항상 되돌립니다.
+	if (const auto PSC = Entry.PSC.Get())
+	{
+		PSC->CustomTimeDilation = 1.f;
+		PSC->OnSystemFinished.RemoveDynamic(this, &UTimeDilationSubsystem::OnSystemFinished);
+	}
+
+	Group.Entries.RemoveAt(Index);
+	--NumEntries;
+	SET_DWORD_STAT(STAT_DilationEntries, NumEntries);
+}
+
+void UTimeDilationSubsystem::Apply(FGroup& Group)
+{
+	const auto Scale = Group.AppliedScale;
+	auto bRemoved = false;
+
+	for (auto It = Group.Entries.CreateIterator(); It; ++It)
+	{
+		if (const auto Actor = It->Actor.Get()) Actor->CustomTimeDilation = Scale;
+		else if (const auto PSC = It->PSC.Get()) PSC->CustomTimeDilation = Scale;
+		else
+		{
+			It.RemoveCurrent();
+			--NumEntries;
+			bRemoved = true;
+			continue;
+		}
+		INC_DWORD_STAT(STAT_DilationWrites);
+	}
+
+	if (bRemoved)
+	{
+		Group.Entries.Shrink();
+		SET_DWORD_STAT(STAT_DilationEntries, NumEntries);
+	}
+}
+
+void UTimeDilationSubsystem::Sweep(FGroup& Group, int32 Budget)
+{
+	auto&& Entries = Group.Entries;
+	const auto Max = Entries.GetMaxIndex();
+	auto bShrink = false;
+
+	for (Budget = FMath::Min(Budget, Max); Budget > 0; --Budget)
+	{
+		// 한 바퀴를 돌 때마다 Unregister가 남긴 끝쪽 빈자리도 함께 줄입니다.
+		if (Group.Cursor >= Max)
+		{
+			Group.Cursor = 0;
+			bShrink = true;
+		}
+
+		const auto Index = Group.Cursor++;
+		if (!Entries.IsAllocated(Index)) continue;
+
+		auto&& Entry = Entries[Index];
+		if (!Entry.Actor.IsValid() && !Entry.PSC.IsValid())
+		{
+			Remove(Group, Index, false);
+			bShrink = true;
+		}
+	}
+
+	if (bShrink) Entries.Shrink();
+}
+
+void UTimeDilationSubsystem::OnSystemFinished(UParticleSystemComponent* const PSC)
+{
+	// 재생 중인 파티클만 남아 있으므로 그룹의 크기는 작습니다.
+	for (auto&& Group : Groups)
+	{
+		for (auto It = Group.Entries.CreateConstIterator(); It; ++It)
+		{
+			if (It->PSC.Get() == PSC)
+			{
+				Remove(Group, It.GetIndex(), true);
+				return;
+			}
+		}
+	}
+}
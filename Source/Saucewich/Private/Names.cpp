@@ -23,4 +23,5 @@ namespace Names
 	const FName Win = TEXT("Win");
 	const FName Draw = TEXT("Draw");
 	const FName Lose = TEXT("Lose");
+	const FName Cosmetic = TEXT("Cosmetic");
 }
@@ -13,3 +13,12 @@ UMaterialInterface* UCharacterData::GetTranslMat(const uint8 Idx, const UMateria
 
 	return nullptr;
 }
+
+void UCharacterData::GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const
+{
+	for (auto&& Sound : DeathSounds) OutPaths.Add(Sound.ToSoftObjectPath());
+	OutPaths.Add(DeathFX.ToSoftObjectPath());
+	OutPaths.Add(DeathFBB.ToSoftObjectPath());
+	OutPaths.Add(DeathShake.ToSoftObjectPath());
+	OutPaths.Add(HitShake.ToSoftObjectPath());
+}
@@ -6,6 +6,7 @@
 #include "EngineUtils.h"
 #include "TimerManager.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 #include "GameMode/SaucewichGameMode.h"
 #include "GameMode/SaucewichGameState.h"
@@ -47,6 +48,7 @@ void ASaucewichPlayerState::OnKill()
 	if (!GS->IsMatchInProgress()) return;
 
 	++Kill;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASaucewichPlayerState, Kill, this);
 	AddScore(NAME("Kill"));
 }
 
@@ -58,6 +60,7 @@ void ASaucewichPlayerState::OnDeath()
 	if (!GS || !GS->IsMatchInProgress()) return;
 
 	++Death;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASaucewichPlayerState, Death, this);
 }
 
 void ASaucewichPlayerState::AddScore(const FName ScoreID, int32 ActualScore, const bool bForce)
@@ -86,6 +89,7 @@ void ASaucewichPlayerState::SetTeam(const uint8 NewTeam)
 	{
 		const auto OldTeam = Team;
 		Team = NewTeam;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ASaucewichPlayerState, Team, this);
 		OnTeamChanged(OldTeam);
 	}
 }
@@ -96,7 +100,10 @@ void ASaucewichPlayerState::OnTeamChanged(const uint8 OldTeam)
 	OnTeamChangedNative.Broadcast(Team);
 
 	if (const auto GS = CastChecked<ASaucewichGameState>(GetWorld()->GetGameState(), ECastCheckedType::NullAllowed))
+	{
+		GS->UpdatePlayerTeam(this);
 		GS->OnPlayerChangedTeam.Broadcast(this, OldTeam, Team);
+	}
 }
 
 void ASaucewichPlayerState::SetWeapon_Internal(const uint8 Slot, const TSoftClassPtr<AWeapon>& Weapon)
@@ -182,6 +189,7 @@ void ASaucewichPlayerState::SetObjective(const uint8 NewObjective)
 	if (!GS || !GS->IsMatchInProgress()) return;
 
 	Objective = NewObjective;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ASaucewichPlayerState, Objective, this);
 }
 
 void ASaucewichPlayerState::BindOnTeamChanged(FOnTeamChangedNative::FDelegate&& Callback)
@@ -255,8 +263,11 @@ void ASaucewichPlayerState::OnRep_PlayerName()
 void ASaucewichPlayerState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(ASaucewichPlayerState, Team);
-	DOREPLIFETIME(ASaucewichPlayerState, Objective);
-	DOREPLIFETIME(ASaucewichPlayerState, Kill);
-	DOREPLIFETIME(ASaucewichPlayerState, Death);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASaucewichPlayerState, Team, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASaucewichPlayerState, Objective, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASaucewichPlayerState, Kill, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ASaucewichPlayerState, Death, Params);
 }
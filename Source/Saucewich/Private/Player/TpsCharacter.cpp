@@ -13,6 +13,7 @@
 #include "Particles/ParticleSystemComponent.h"
 #include "TimerManager.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Sound/SoundBase.h"
 
 #include "Saucewich.h"
@@ -36,12 +37,12 @@ ATpsCharacter::ATpsCharacter(const FObjectInitializer& ObjectInitializer)
 	WeaponComponent{CreateDefaultSubobject<UWeaponComponent>(Names::WeaponComponent)},
 	SpringArm{CreateDefaultSubobject<USpringArmComponent>(Names::SpringArm)},
 	Camera{CreateDefaultSubobject<UCameraComponent>(Names::Camera)},
-	Shadow{CreateDefaultSubobject<UShadowComponent>(Names::Shadow)}
+	Shadow{Cosmetic::CreateSubobject<UShadowComponent>(this, Names::Shadow)}
 {
 	WeaponComponent->SetupAttachment(GetMesh(), Names::Weapon);
 	SpringArm->SetupAttachment(RootComponent);
 	Camera->SetupAttachment(SpringArm);
-	Shadow->SetupAttachment(RootComponent);
+	if (Shadow) Shadow->SetupAttachment(RootComponent);
 }
 
 AWeapon* ATpsCharacter::GetActiveWeapon() const
@@ -120,6 +121,7 @@ FVector ATpsCharacter::GetSpringArmLocation() const
 void ATpsCharacter::PostInitializeComponents()
 {
 	Super::PostInitializeComponents();
+	Cosmetic::Strip(this, Shadow);
 
 	const auto ColMatIdx = GetColIdx();
 	const auto Transl = Data->GetTranslMat(ColMatIdx, GetMesh()->GetMaterial(ColMatIdx));
@@ -132,6 +134,9 @@ void ATpsCharacter::PossessedBy(AController* const NewController)
 {
 	Super::PossessedBy(NewController);
 	OnControllerChanged();
+
+	if (const auto GS = GetWorld()->GetGameState<ASaucewichGameState>())
+		GS->UpdateCharacterTeam(this);
 }
 
 void ATpsCharacter::OnRep_Controller()
@@ -142,9 +147,9 @@ void ATpsCharacter::OnRep_Controller()
 
 void ATpsCharacter::OnControllerChanged()
 {
-	if (const auto Ctrl = GetController())
+	// 벤치마크 봇처럼 플레이어 컨트롤러가 아닌 컨트롤러도 캐릭터를 조종할 수 있습니다.
+	if (const auto PC = GetController<ASaucewichPlayerController>())
 	{
-		const auto PC = CastChecked<ASaucewichPlayerController>(Ctrl);
 		ASaucewichPlayerController::BroadcastCharacterSpawned(PC, this);
 	}
 }
@@ -158,15 +163,16 @@ void ATpsCharacter::BeginPlay()
 	if (HasAuthority())
 	{
 		bAlive = true;
+		MARK_PROPERTY_DIRTY_FROM_NAME(ATpsCharacter, bAlive, this);
 		if (Data != nullptr)
 		{
 			HP = Data->MaxHP;
+			MARK_PROPERTY_DIRTY_FROM_NAME(ATpsCharacter, HP, this);
 			OnRep_HP();
 		}
 	}
 
-	const auto GS = CastChecked<ASaucewichGameState>(GetWorld()->GetGameState());
-	GS->AddDilatableActor(this);
+	DilationHandle = UTimeDilationSubsystem::Get(this)->Register(this);
 }
 
 void ATpsCharacter::Destroyed()
@@ -175,6 +181,13 @@ void ATpsCharacter::Destroyed()
 	{
 		PS->OnCharDestroyed();
 	}
+
+	if (const auto GS = GetWorld()->GetGameState<ASaucewichGameState>())
+		GS->RemoveCharacter(this);
+
+	if (const auto Dilation = UTimeDilationSubsystem::Get(this))
+		Dilation->Unregister(DilationHandle);
+
 	Super::Destroyed();
 }
 
@@ -194,8 +207,10 @@ void ATpsCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLif
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(ATpsCharacter, HP);
-	DOREPLIFETIME(ATpsCharacter, bAlive);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATpsCharacter, HP, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(ATpsCharacter, bAlive, Params);
 }
 
 float ATpsCharacter::TakeDamage(float DamageAmount, const FDamageEvent& DamageEvent, AController* const EventInstigator, AActor* const DamageCauser)
@@ -223,6 +238,7 @@ float ATpsCharacter::TakeDamage(float DamageAmount, const FDamageEvent& DamageEv
 		else
 		{
 			HP = NewHP;
+			MARK_PROPERTY_DIRTY_FROM_NAME(ATpsCharacter, HP, this);
 			if (HasAuthority()) OnRep_HP();
 		}
 	}
@@ -236,7 +252,7 @@ float ATpsCharacter::TakeDamage(float DamageAmount, const FDamageEvent& DamageEv
 		if (UUserSettings::Get(this)->bVibration)
 			PC->PlayDynamicForceFeedback(Val, Val, false, true, false, true);
 
-		PC->ClientPlayCameraShake(Data->HitShake.LoadSynchronous(), Val);
+		PC->ClientPlayCameraShake(SyncLoad::Load(Data->HitShake, this), Val);
 	}
 #endif
 	
@@ -274,6 +290,8 @@ void ATpsCharacter::SetPlayerDefaults()
 		{
 			bAlive = true;
 			HP = Data->MaxHP;
+			MARK_PROPERTY_DIRTY_FROM_NAME(ATpsCharacter, bAlive, this);
+			MARK_PROPERTY_DIRTY_FROM_NAME(ATpsCharacter, HP, this);
 			OnRep_HP();
 		}
 		if (Data->RespawnInvincibleTime > 0)
@@ -287,7 +305,7 @@ void ATpsCharacter::SetPlayerDefaults()
 		}
 	}
 
-	if (const auto PC = CastChecked<ASaucewichPlayerController>(GetController(), ECastCheckedType::NullAllowed))
+	if (const auto PC = GetController<ASaucewichPlayerController>())
 	{
 		PC->BroadcastRespawn();
 	}
@@ -309,6 +327,7 @@ void ATpsCharacter::Kill(ASaucewichPlayerState* const Attacker, AActor* const In
 void ATpsCharacter::KillSilent()
 {
 	bAlive = false;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATpsCharacter, bAlive, this);
 	SetActorActivated(false);
 
 	if (HasAuthority())
@@ -320,7 +339,7 @@ void ATpsCharacter::KillSilent()
 	WeaponComponent->OnCharacterDeath();
 	OnCharacterDeath.Broadcast();
 
-	if (const auto PC = CastChecked<ASaucewichPlayerController>(GetController(), ECastCheckedType::NullAllowed))
+	if (const auto PC = GetController<ASaucewichPlayerController>())
 	{
 		PC->BroadcastDeath();
 	}
@@ -347,6 +366,9 @@ void ATpsCharacter::SetActorActivated(const bool bActive)
 void ATpsCharacter::OnTeamChanged(const uint8 NewTeam)
 {
 	SetColor(GetTeamColor());
+
+	if (const auto GS = GetWorld()->GetGameState<ASaucewichGameState>())
+		GS->UpdateCharacterTeam(this);
 }
 
 void ATpsCharacter::BindOnTeamChanged()
@@ -388,13 +410,15 @@ void ATpsCharacter::Kill_Internal(ASaucewichPlayerState* const Attacker, AActor*
 {
 	HP = 0;
 	bAlive = false;
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATpsCharacter, HP, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(ATpsCharacter, bAlive, this);
 	OnRep_HP();
 	SetActorActivated(false);
 
 	WeaponComponent->OnCharacterDeath();
 	OnCharacterDeath.Broadcast();
 	
-	if (const auto PC = CastChecked<ASaucewichPlayerController>(GetController(), ECastCheckedType::NullAllowed))
+	if (const auto PC = GetController<ASaucewichPlayerController>())
 	{
 		PC->BroadcastDeath();
 	}
@@ -426,13 +450,12 @@ void ATpsCharacter::SpawnDeathEffects() const
 #if !UE_SERVER
 	const auto World = GetWorld();
 	auto Location = GetActorLocation();
-	UGameplayStatics::PlaySoundAtLocation(World, Data->DeathSounds[FMath::RandHelper(Data->DeathSounds.Num())].LoadSynchronous(), Location);
+	UGameplayStatics::PlaySoundAtLocation(World, SyncLoad::Load(Data->DeathSounds[FMath::RandHelper(Data->DeathSounds.Num())], World), Location);
 
-	const auto PSC = UGameplayStatics::SpawnEmitterAtLocation(World, Data->DeathFX.LoadSynchronous(), FTransform{ Location }, true, EPSCPoolMethod::AutoRelease);
+	const auto PSC = UGameplayStatics::SpawnEmitterAtLocation(World, SyncLoad::Load(Data->DeathFX, World), FTransform{ Location }, true, EPSCPoolMethod::AutoRelease);
 	PSC->SetColorParameter(Names::Color, GetColor());
 
-	const auto GS = CastChecked<ASaucewichGameState>(World->GetGameState());
-	GS->AddDilatablePSC(PSC);
+	UTimeDilationSubsystem::Get(World)->Register(PSC);
 
 	Location.Z -= GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
 	ASauceMarker::Add(this, GetTeam(), Location, Data->DeathSauceMarkScale);
@@ -441,9 +464,9 @@ void ATpsCharacter::SpawnDeathEffects() const
 	if (PC && PC->IsLocalController())
 	{
 		if (UUserSettings::Get(this)->bVibration)
-			PC->ClientPlayForceFeedback(Data->DeathFBB.LoadSynchronous());
+			PC->ClientPlayForceFeedback(SyncLoad::Load(Data->DeathFBB, this));
 
-		PC->ClientPlayCameraShake(Data->DeathShake.LoadSynchronous());
+		PC->ClientPlayCameraShake(SyncLoad::Load(Data->DeathShake, this));
 	}
 #endif
 }
@@ -513,9 +536,8 @@ void ATpsCharacter::MulticastAddPerk_Implementation(UClass* const PerkClass)
 	});
 	GetWorldTimerManager().SetTimer(Perk.Timer, Delegate, Def->GetDuration(), false);
 
-	if (GetController())
+	if (const auto PC = GetController<ASaucewichPlayerController>())
 	{
-		const auto PC = CastChecked<ASaucewichPlayerController>(GetController());
 		PC->PrintMessageLocal(Def->GetPickupMsg(), 3, EMsgType::Left);
 	}
 }
@@ -4,8 +4,12 @@
 
 #include "EngineUtils.h"
 #include "Modules/ModuleManager.h"
+#include "GameFramework/GameState.h"
+#include "GameFramework/Pawn.h"
 #include "GameFramework/InputSettings.h"
 #include "Kismet/BlueprintPlatformLibrary.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "UObject/UObjectHash.h"
 
 #include "Names.h"
 
@@ -17,6 +21,86 @@ IMPLEMENT_PRIMARY_GAME_MODULE(FDefaultGameModuleImpl, Saucewich, "Saucewich")
 
 DEFINE_LOG_CATEGORY(LogSaucewich)
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sync Loads In Match"), STAT_SyncLoadsInMatch, STATGROUP_Saucewich);
+
+void SyncLoad::Report(const UObject* const WorldContextObject, const FSoftObjectPath& Path, const double Seconds)
+{
+	const auto World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const auto GS = World ? World->GetGameState<AGameState>() : nullptr;
+	if (!GS || GS->GetMatchState() != MatchState::InProgress) return;
+
+	INC_DWORD_STAT(STAT_SyncLoadsInMatch);
+	UE_LOG(LogSaucewich, Warning, TEXT("Hitch: %s was loaded synchronously during the match (%.2f ms)"), *Path.ToString(), Seconds * 1000.0);
+}
+
+bool Cosmetic::IsEnabled(const UObject* const WorldContextObject)
+{
+	if (IsRunningDedicatedServer()) return false;
+	const auto World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return !World || World->GetNetMode() != NM_DedicatedServer;
+}
+
+void Cosmetic::MarkComponent(UActorComponent* const Component)
+{
+	Component->ComponentTags.Add(Names::Cosmetic);
+}
+
+#if !UE_BUILD_SHIPPING
+static bool IsCosmeticObject(const UObject* Obj)
+{
+	for (; Obj; Obj = Obj->GetOuter())
+		if (const auto Component = Cast<UActorComponent>(Obj))
+			return Component->ComponentHasTag(Names::Cosmetic);
+
+	return false;
+}
+
+static void CountActorMemory(AActor* const Actor, SIZE_T& OutTotal, SIZE_T& OutCosmetic)
+{
+	const auto Count = [&](UObject* const Obj)
+	{
+		const auto Size = FArchiveCountMem{Obj}.GetMax() + Obj->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+		OutTotal += Size;
+		if (IsCosmeticObject(Obj)) OutCosmetic += Size;
+	};
+
+	Count(Actor);
+	ForEachObjectWithOuter(Actor, Count, true);
+
+	TArray<AActor*> Attached;
+	Actor->GetAttachedActors(Attached);
+	for (const auto Child : Attached) CountActorMemory(Child, OutTotal, OutCosmetic);
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice PlayerMemReport{
+	TEXT("Saucewich.MemReport.Player"),
+	TEXT("Prints the memory used by each player's pawn and attached weapons, and how much of it belongs to cosmetic components that dedicated servers do not create"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>&, UWorld* const World, FOutputDevice& Ar)
+	{
+		if (!World) return;
+
+		SIZE_T Total = 0, Cosmetic = 0;
+		auto NumPlayers = 0;
+		for (TActorIterator<APawn> It{World}; It; ++It)
+		{
+			if (!It->GetPlayerState()) continue;
+
+			SIZE_T PawnTotal = 0, PawnCosmetic = 0;
+			CountActorMemory(*It, PawnTotal, PawnCosmetic);
+			Ar.Logf(TEXT("%-32s %8.1f KB (cosmetic %8.1f KB)"), *It->GetName(), PawnTotal / 1024.f, PawnCosmetic / 1024.f);
+
+			Total += PawnTotal;
+			Cosmetic += PawnCosmetic;
+			++NumPlayers;
+		}
+
+		if (NumPlayers == 0) return;
+		Ar.Logf(TEXT("Per player: %.1f KB with cosmetic components, %.1f KB without (dedicated server)"),
+			Total / 1024.f / NumPlayers, (Total - Cosmetic) / 1024.f / NumPlayers);
+	})
+};
+#endif
+
 #if WITH_GAMELIFT
 
 DEFINE_LOG_CATEGORY(LogGameLift)
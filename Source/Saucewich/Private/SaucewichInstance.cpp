@@ -2,6 +2,7 @@
 
 #include "SaucewichInstance.h"
 
+#include "Engine/AssetManager.h"
 #include "Engine/World.h"
 #include "Engine/Engine.h"
 
@@ -11,6 +12,10 @@
 #include "Matchmaker.h"
 #include "Saucewich.h"
 #include "GameMode/SaucewichGameMode.h"
+#include "Player/CharacterData.h"
+#include "Player/TpsCharacter.h"
+#include "Weapon/Weapon.h"
+#include "Weapon/Projectile/Projectile.h"
 
 #if WITH_GAMELIFT
 	#include "GameLiftServerSDK.h"
@@ -87,6 +92,9 @@ void USaucewichInstance::Init()
 #endif
 
 	GEngine->NetworkFailureEvent.AddUObject(this, &USaucewichInstance::OnNetworkError);
+	FWorldDelegates::OnSeamlessTravelStart.AddUObject(this, &USaucewichInstance::OnSeamlessTravelStart);
+
+	PreloadAssets();
 
 	UE_LOG(LogSaucewich, Log, TEXT("BUILD TIME: " __DATE__ " " __TIME__));
 }
@@ -98,6 +106,82 @@ void USaucewichInstance::OnNetworkError(UWorld*, UNetDriver*, const ENetworkFail
 		FText::FromString(EnumPtr->GetNameStringByIndex(Type)), FText::FromString(Msg)));
 }
 
+void USaucewichInstance::OnSeamlessTravelStart(UWorld* const World, const FString& MapName)
+{
+	if (World && World->GetGameInstance() == this)
+		PreloadAssets();
+}
+
+void USaucewichInstance::PreloadAssets()
+{
+	TArray<FSoftObjectPath> Paths;
+	for (auto&& GameMode : GameModes) Paths.Add(GameMode.ToSoftObjectPath());
+	for (auto&& Weapon : PrimaryWeapons) Paths.Add(Weapon.ToSoftObjectPath());
+	for (auto&& Weapon : SecondaryWeapons) Paths.Add(Weapon.ToSoftObjectPath());
+	Paths.Add(SauceMarkerClass.ToSoftObjectPath());
+
+	// 이미 요청한 에셋은 기존 핸들이 계속 붙잡고 있으므로 건너뛰고, 취소된 요청에 들어 있던 에셋만 다시 요청합니다.
+	// 매 이동마다 모든 핸들을 새로 만들면 오래 켜져 있는 서버에서 핸들이 끝없이 쌓입니다.
+	PreloadHandles.RemoveAll([this, &Paths](const TSharedPtr<FStreamableHandle>& Handle)
+	{
+		if (!Handle->WasCanceled()) return false;
+
+		TArray<FSoftObjectPath> Canceled;
+		Handle->GetRequestedAssets(Canceled);
+		for (auto&& Path : Canceled) PreloadedPaths.Remove(Path);
+		Paths.Append(MoveTemp(Canceled));
+		return true;
+	});
+
+	RequestPreload(MoveTemp(Paths));
+}
+
+void USaucewichInstance::RequestPreload(TArray<FSoftObjectPath>&& Paths)
+{
+	Paths.RemoveAll([this](const FSoftObjectPath& Path)
+	{
+		bool bAlreadyInSet;
+		if (!Path.IsNull()) PreloadedPaths.Add(Path, &bAlreadyInSet);
+		return Path.IsNull() || bAlreadyInSet;
+	});
+	if (Paths.Num() == 0) return;
+
+	UE_LOG(LogSaucewich, Log, TEXT("Preloading %d assets..."), Paths.Num());
+
+	auto&& Callback = FStreamableDelegate::CreateUObject(this, &USaucewichInstance::OnPreloaded, Paths);
+	if (auto Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MoveTemp(Paths), MoveTemp(Callback)))
+		PreloadHandles.Add(MoveTemp(Handle));
+}
+
+void USaucewichInstance::OnPreloaded(const TArray<FSoftObjectPath> Loaded)
+{
+	TArray<FSoftObjectPath> Next;
+	for (auto&& Path : Loaded)
+	{
+		const auto Class = Cast<UClass>(Path.ResolveObject());
+		if (!Class) continue;
+
+		if (Class->IsChildOf<AWeapon>())
+		{
+			GetDefault<AWeapon>(Class)->GetAssetsToLoad(Next);
+		}
+		else if (Class->IsChildOf<AProjectile>())
+		{
+			GetDefault<AProjectile>(Class)->GetAssetsToLoad(Next);
+		}
+#if !UE_SERVER
+		else if (Class->IsChildOf<AGameModeBase>())
+		{
+			const auto Pawn = GetDefault<AGameModeBase>(Class)->DefaultPawnClass;
+			if (Pawn && Pawn->IsChildOf<ATpsCharacter>())
+				if (const auto Data = GetDefault<ATpsCharacter>(Pawn)->GetCharacterData())
+					Data->GetAssetsToLoad(Next);
+		}
+#endif
+	}
+
+	RequestPreload(MoveTemp(Next));
+}
 
 #if WITH_GAMELIFT
 
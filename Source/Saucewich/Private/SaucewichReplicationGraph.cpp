@@ -0,0 +1,238 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#include "SaucewichReplicationGraph.h"
+
+#include "Engine/LevelScriptActor.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+#include "Entity/Pickup.h"
+#include "Entity/PoolActor.h"
+#include "Player/TpsCharacter.h"
+#include "Weapon/Weapon.h"
+#include "Weapon/Projectile/Projectile.h"
+
+static TAutoConsoleVariable<float> CVarCellSize{
+	TEXT("Saucewich.RepGraph.CellSize"), 2500.f,
+	TEXT("Size of a spatial grid cell used by the replication graph. Takes effect on the next map.")
+};
+
+static TAutoConsoleVariable<float> CVarSpatialBias{
+	TEXT("Saucewich.RepGraph.SpatialBias"), -50000.f,
+	TEXT("Lowest X and Y coordinate covered by the spatial grid. Takes effect on the next map.")
+};
+
+void USaucewichReplicationGraph::ResetGameWorldState()
+{
+	Super::ResetGameWorldState();
+	ActorsWithoutNetConnection.Reset();
+}
+
+void USaucewichReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// 명시적으로 정한 클래스. 나머지는 GetMappingPolicy가 부모 클래스나 CDO를 보고 정합니다.
+	ClassRepNodePolicies.Set(AWeapon::StaticClass(), EClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(ALevelScriptActor::StaticClass(), EClassRepNodeMapping::NotRouted);
+	ClassRepNodePolicies.Set(AGameStateBase::StaticClass(), EClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(APlayerState::StaticClass(), EClassRepNodeMapping::RelevantAllConnections);
+	ClassRepNodePolicies.Set(ATpsCharacter::StaticClass(), EClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(AProjectile::StaticClass(), EClassRepNodeMapping::Spatialize_Dynamic);
+	ClassRepNodePolicies.Set(APickup::StaticClass(), EClassRepNodeMapping::Spatialize_Dormancy);
+	ClassRepNodePolicies.Set(APoolActor::StaticClass(), EClassRepNodeMapping::Spatialize_Dormancy);
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		const auto Class = *It;
+		if (!Class->IsChildOf<AActor>() || Class->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists)) continue;
+
+		const auto CDO = Class->GetDefaultObject<AActor>();
+		if (!CDO || !CDO->GetIsReplicated()) continue;
+
+		const auto Policy = GetMappingPolicy(Class);
+		if (Policy == EClassRepNodeMapping::NotRouted || Policy == EClassRepNodeMapping::RelevantAllConnections) continue;
+
+		FClassReplicationInfo Info;
+		InitClassReplicationInfo(Info, Class, true);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, Info);
+	}
+
+	WeaponOwnerChangedHandle = AWeapon::OnOwnerChanged.AddUObject(this, &USaucewichReplicationGraph::OnWeaponOwnerChanged);
+}
+
+void USaucewichReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = CVarCellSize.GetValueOnGameThread();
+	const auto Bias = CVarSpatialBias.GetValueOnGameThread();
+	GridNode->SpatialBias = FVector2D{Bias, Bias};
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void USaucewichReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* const RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	const auto Node = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(Node, RepGraphConnection);
+	ConnectionNodes.Add(RepGraphConnection->NetConnection, Node);
+}
+
+void USaucewichReplicationGraph::RemoveClientConnection(UNetConnection* const NetConnection)
+{
+	ConnectionNodes.Remove(NetConnection);
+	Super::RemoveClientConnection(NetConnection);
+}
+
+void USaucewichReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	const auto Actor = ActorInfo.Actor;
+
+	// 플레이어 컨트롤러처럼 주인에게만 보이는 액터는 연결이 정해진 뒤 그 연결의 노드에 넣습니다.
+	if (Actor->bOnlyRelevantToOwner)
+	{
+		ActorsWithoutNetConnection.Add(Actor);
+		return;
+	}
+
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+
+	case EClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+
+	case EClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+
+	case EClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+
+	default:
+		break;
+	}
+}
+
+void USaucewichReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	const auto Actor = ActorInfo.Actor;
+
+	if (Actor->bOnlyRelevantToOwner)
+	{
+		ActorsWithoutNetConnection.RemoveSingleSwap(Actor, false);
+		if (const auto Node = GetAlwaysRelevantNode(Actor->GetNetConnection()))
+			Node->NotifyRemoveNetworkActor(ActorInfo, false);
+		return;
+	}
+
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case EClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+
+	case EClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+
+	case EClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+
+	case EClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+
+	default:
+		break;
+	}
+}
+
+int32 USaucewichReplicationGraph::ServerReplicateActors(const float DeltaSeconds)
+{
+	for (auto i = ActorsWithoutNetConnection.Num() - 1; i >= 0; --i)
+	{
+		const auto Actor = ActorsWithoutNetConnection[i];
+		if (!IsValid(Actor))
+		{
+			ActorsWithoutNetConnection.RemoveAtSwap(i, 1, false);
+			continue;
+		}
+
+		if (const auto Node = GetAlwaysRelevantNode(Actor->GetNetConnection()))
+		{
+			Node->NotifyAddNetworkActor(FNewReplicatedActorInfo{Actor});
+			ActorsWithoutNetConnection.RemoveAtSwap(i, 1, false);
+		}
+	}
+
+	return Super::ServerReplicateActors(DeltaSeconds);
+}
+
+void USaucewichReplicationGraph::BeginDestroy()
+{
+	AWeapon::OnOwnerChanged.Remove(WeaponOwnerChangedHandle);
+	Super::BeginDestroy();
+}
+
+EClassRepNodeMapping USaucewichReplicationGraph::GetMappingPolicy(UClass* const Class)
+{
+	if (const auto Policy = ClassRepNodePolicies.Get(Class))
+		return *Policy;
+
+	const auto CDO = Class->GetDefaultObject<AActor>();
+	auto Policy = EClassRepNodeMapping::Spatialize_Dormancy;
+	if (CDO->bAlwaysRelevant) Policy = EClassRepNodeMapping::RelevantAllConnections;
+	else if (!CDO->IsReplicatingMovement()) Policy = EClassRepNodeMapping::Spatialize_Static;
+
+	ClassRepNodePolicies.Set(Class, Policy);
+	return Policy;
+}
+
+void USaucewichReplicationGraph::InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* const Class, const bool bSpatialize) const
+{
+	const auto CDO = Class->GetDefaultObject<AActor>();
+	if (bSpatialize) Info.SetCullDistanceSquared(CDO->NetCullDistanceSquared);
+
+	const auto ServerMaxTickRate = NetDriver ? NetDriver->NetServerMaxTickRate : 30;
+	Info.ReplicationPeriodFrame = FMath::Max<uint32>(FMath::RoundToFloat(ServerMaxTickRate / CDO->NetUpdateFrequency), 1);
+}
+
+UReplicationGraphNode_AlwaysRelevant_ForConnection* USaucewichReplicationGraph::GetAlwaysRelevantNode(UNetConnection* const Connection) const
+{
+	const auto Node = Connection ? ConnectionNodes.Find(Connection) : nullptr;
+	return Node ? *Node : nullptr;
+}
+
+void USaucewichReplicationGraph::OnWeaponOwnerChanged(AWeapon* const Weapon, AActor* const OldOwner, AActor* const NewOwner)
+{
+	if (Weapon->GetWorld() != GetWorld()) return;
+
+	// 무기는 주인 캐릭터가 리플리케이트될 때 함께 리플리케이트됩니다.
+	// 풀로 반납되어 주인이 없어진 무기는 어디에도 모이지 않으므로 채널이 닫히고 클라이언트에서 사라집니다.
+	if (OldOwner)
+	{
+		if (const auto Info = GlobalActorReplicationInfoMap.Find(OldOwner))
+			Info->DependentActorList.RemoveFast(Weapon);
+	}
+
+	if (NewOwner)
+	{
+		auto&& Info = GlobalActorReplicationInfoMap.Get(NewOwner);
+		Info.DependentActorList.PrepareForWrite();
+		Info.DependentActorList.ConditionalAdd(Weapon);
+	}
+}
@@ -3,12 +3,13 @@
 #include "ShadowComponent.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "SaucewichInstance.h"
+#include "ShadowSubsystem.h"
 #include "Names.h"
 
 UShadowComponent::UShadowComponent()
 {
 #if !UE_SERVER
-	PrimaryComponentTick.bCanEverTick = true;
+	if (IsRunningDedicatedServer()) return;
 	const auto Mesh = TSoftObjectPtr<UStaticMesh>{{TEXT("StaticMesh'/Engine/BasicShapes/Plane.Plane'")}}.LoadSynchronous();
 	UStaticMeshComponent::SetStaticMesh(Mesh);
 	BodyInstance.SetCollisionProfileNameDeferred(Names::NoCollision);
@@ -18,19 +19,17 @@ UShadowComponent::UShadowComponent()
 
 #if !UE_SERVER
 
-void UShadowComponent::BeginPlay()
+bool UShadowComponent::NeedsUpdate(const float Threshold, const float MaxInterval, const float Now) const
 {
-	Super::BeginPlay();
-	
-	Offset.SetLocation(GetRelativeLocation());
-	CreateDynamicMaterialInstance(0);
+	if (GetOwner()->IsHidden()) return false;
+	if (Now - LastUpdateTime >= MaxInterval) return true;
+	return !GetTraceStart().Equals(LastStart, Threshold);
 }
 
-void UShadowComponent::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* const ThisTickFunction)
+int32 UShadowComponent::UpdateShadow(const float Now)
 {
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
 	auto bShouldDraw = false;
+	auto NumTraces = 1;
 
 	const auto World = GetWorld();
 	const auto Transform = Offset * GetAttachParent()->GetComponentTransform();
@@ -41,6 +40,9 @@ void UShadowComponent::TickComponent(const float DeltaTime, const ELevelTick Tic
 	auto End = Start;
 	End.Z -= MaxDist;
 
+	LastStart = Start;
+	LastUpdateTime = Now;
+
 	FCollisionQueryParams Params;
 	Params.AddIgnoredActor(GetOwner());
 
@@ -56,6 +58,7 @@ void UShadowComponent::TickComponent(const float DeltaTime, const ELevelTick Tic
 		{
 			const auto St = Start + Rot.RotateVector(Dir) * (Scale.X * 50.f);
 			FHitResult H;
+			++NumTraces;
 			if (World->LineTraceSingleByChannel(H, St, St - Hit.ImpactNormal * (Hit.Distance + 1.f), ECC_Visibility, Params)
 				&& FMath::Abs(Hit.Distance - H.Distance) <= 1.f)
 			{
@@ -68,6 +71,7 @@ void UShadowComponent::TickComponent(const float DeltaTime, const ELevelTick Tic
 		{
 			const auto Size = Scale.X * 50.f;
 			FHitResult H;
+			++NumTraces;
 			const auto bOverlapped = World->SweepSingleByChannel(
 				H, Start, Start - Hit.ImpactNormal * (Hit.Distance + 1.f), Rot,
 				USaucewichInstance::Get(World)->GetDecalTraceChannel(),
@@ -75,15 +79,50 @@ void UShadowComponent::TickComponent(const float DeltaTime, const ELevelTick Tic
 			);
 			if (bOverlapped && H.Distance < MinDist) MinDist = H.Distance;
 
-			const auto Mat = CastChecked<UMaterialInstanceDynamic>(GetMaterial(0));
-			Mat->SetScalarParameterValue(NAME("Dist"), MinDist / MaxDist);
-			Mat->SetScalarParameterValue(NAME("Opacity"), static_cast<float>(Num) / Offsets.size());
+			SetMaterialParams(MinDist / MaxDist, static_cast<float>(Num) / Offsets.size());
 			SetWorldLocationAndRotation(Hit.ImpactPoint + Hit.ImpactNormal * (Hit.Distance - MinDist + .01f), Rot);
 			bShouldDraw = true;
 		}
 	}
 
 	SetVisibility(bShouldDraw);
+	return NumTraces;
 }
 
-#endif 
+void UShadowComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	
+	Offset.SetLocation(GetRelativeLocation());
+	CreateDynamicMaterialInstance(0);
+
+	if (const auto Subsystem = UShadowSubsystem::Get(this))
+		Subsystem->Register(this);
+}
+
+void UShadowComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (const auto Subsystem = UShadowSubsystem::Get(this))
+		Subsystem->Unregister(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+FVector UShadowComponent::GetTraceStart() const
+{
+	return (Offset * GetAttachParent()->GetComponentTransform()).GetLocation();
+}
+
+void UShadowComponent::SetMaterialParams(const float NewDist, const float NewOpacity)
+{
+	// 값이 거의 그대로면 렌더 스레드로 보내지 않습니다.
+	const auto bDist = !FMath::IsNearlyEqual(Dist, NewDist, 1e-3f);
+	const auto bOpacity = !FMath::IsNearlyEqual(Opacity, NewOpacity, 1e-3f);
+	if (!bDist && !bOpacity) return;
+
+	const auto Mat = CastChecked<UMaterialInstanceDynamic>(GetMaterial(0));
+	if (bDist) Mat->SetScalarParameterValue(NAME("Dist"), Dist = NewDist);
+	if (bOpacity) Mat->SetScalarParameterValue(NAME("Opacity"), Opacity = NewOpacity);
+}
+
+#endif
@@ -0,0 +1,105 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#include "ShadowSubsystem.h"
+
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#include "ShadowComponent.h"
+#include "Saucewich.h"
+
+DECLARE_CYCLE_STAT(TEXT("Shadow Update"), STAT_ShadowUpdate, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shadow Traces"), STAT_ShadowTraces, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shadow Updates"), STAT_ShadowUpdates, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shadow Updates Skipped"), STAT_ShadowSkipped, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shadow Updates Deferred"), STAT_ShadowDeferred, STATGROUP_Saucewich);
+
+static TAutoConsoleVariable<int32> CVarTraceBudget{
+	TEXT("Saucewich.Shadow.TraceBudget"), 60,
+	TEXT("Maximum number of traces used to update blob shadows per frame. An update takes up to 6 traces."),
+	ECVF_Scalability
+};
+
+static TAutoConsoleVariable<float> CVarMoveThreshold{
+	TEXT("Saucewich.Shadow.MoveThreshold"), 1.f,
+	TEXT("A blob shadow is updated only when its owner moved more than this distance")
+};
+
+static TAutoConsoleVariable<float> CVarMaxInterval{
+	TEXT("Saucewich.Shadow.MaxInterval"), 1.f,
+	TEXT("A blob shadow is updated at least once every this many seconds even if its owner did not move")
+};
+
+UShadowSubsystem* UShadowSubsystem::Get(const UObject* const WorldContextObject)
+{
+	return WorldContextObject->GetWorld()->GetSubsystem<UShadowSubsystem>();
+}
+
+void UShadowSubsystem::Register(UShadowComponent* const Shadow)
+{
+	Shadows.AddUnique(Shadow);
+}
+
+void UShadowSubsystem::Unregister(UShadowComponent* const Shadow)
+{
+	Shadows.RemoveSingleSwap(Shadow, false);
+}
+
+bool UShadowSubsystem::ShouldCreateSubsystem(UObject* const Outer) const
+{
+#if UE_SERVER
+	return false;
+#else
+	return Super::ShouldCreateSubsystem(Outer);
+#endif
+}
+
+void UShadowSubsystem::Tick(float)
+{
+#if !UE_SERVER
+	SCOPE_CYCLE_COUNTER(STAT_ShadowUpdate);
+
+	const auto Now = GetWorld()->GetTimeSeconds();
+	const auto Threshold = CVarMoveThreshold.GetValueOnGameThread();
+	const auto MaxInterval = CVarMaxInterval.GetValueOnGameThread();
+	auto Budget = CVarTraceBudget.GetValueOnGameThread();
+
+	const auto Num = Shadows.Num();
+	auto NextCursor = INDEX_NONE;
+
+	for (auto i = 0; i < Num; ++i)
+	{
+		const auto Index = (Cursor + i) % Num;
+		const auto Shadow = Shadows[Index];
+		if (!IsValid(Shadow) || !Shadow->NeedsUpdate(Threshold, MaxInterval, Now))
+		{
+			INC_DWORD_STAT(STAT_ShadowSkipped);
+			continue;
+		}
+
+		if (Budget <= 0)
+		{
+			if (NextCursor == INDEX_NONE) NextCursor = Index;
+			INC_DWORD_STAT(STAT_ShadowDeferred);
+			continue;
+		}
+
+		const auto NumTraces = Shadow->UpdateShadow(Now);
+		Budget -= NumTraces;
+		INC_DWORD_STAT(STAT_ShadowUpdates);
+		INC_DWORD_STAT_BY(STAT_ShadowTraces, NumTraces);
+	}
+
+	Cursor = NextCursor == INDEX_NONE ? 0 : NextCursor;
+#endif
+}
+
+bool UShadowSubsystem::IsTickable() const
+{
+	return Shadows.Num() > 0 && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UShadowSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShadowSubsystem, STATGROUP_Tickables);
+}
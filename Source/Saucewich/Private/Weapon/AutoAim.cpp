@@ -0,0 +1,105 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#include "Weapon/AutoAim.h"
+
+#include "Components/CapsuleComponent.h"
+
+#include "Player/TpsCharacter.h"
+
+void FAutoAimSnapshot::Reset()
+{
+	X.Reset();
+	Y.Reset();
+	Z.Reset();
+	Radius.Reset();
+	Segment.Reset();
+	Characters.Reset();
+}
+
+void FAutoAimSnapshot::Add(const ATpsCharacter* const Character)
+{
+	const auto Capsule = Character->GetCapsuleComponent();
+	const auto Location = Capsule->GetComponentLocation();
+	float R, HalfHeight;
+	Capsule->GetScaledCapsuleSize(R, HalfHeight);
+
+	X.Add(Location.X);
+	Y.Add(Location.Y);
+	Z.Add(Location.Z);
+	Radius.Add(R);
+	Segment.Add(FMath::Max(HalfHeight - R, 0.f));
+	Characters.Add(const_cast<ATpsCharacter*>(Character));
+}
+
+void FAutoAimSnapshot::Pad()
+{
+	// 어떤 상자와도 겹치지 않도록 아주 먼 곳에 크기가 없는 캡슐을 둡니다.
+	const auto Padded = Align(Num(), 4);
+	X.SetNum(Padded, false);
+	Y.SetNum(Padded, false);
+	Z.SetNum(Padded, false);
+	Radius.SetNum(Padded, false);
+	Segment.SetNum(Padded, false);
+
+	for (auto i = Num(); i < Padded; ++i)
+	{
+		X[i] = Y[i] = Z[i] = HALF_WORLD_MAX;
+		Radius[i] = Segment[i] = 0.f;
+	}
+}
+
+void AutoAim::Cull(const FAutoAimSnapshot& Snapshot, const FAutoAimQuery& Query, FAutoAimCandidates& OutCandidates)
+{
+	const auto Num = Snapshot.Num();
+	if (Num == 0) return;
+	check(Snapshot.X.Num() % 4 == 0);
+
+	const auto StartX = VectorSetFloat1(Query.Start.X);
+	const auto StartY = VectorSetFloat1(Query.Start.Y);
+	const auto StartZ = VectorSetFloat1(Query.Start.Z);
+
+	const auto DirX = VectorSetFloat1(Query.Dir.X), DirY = VectorSetFloat1(Query.Dir.Y), DirZ = VectorSetFloat1(Query.Dir.Z);
+	const auto RightX = VectorSetFloat1(Query.Right.X), RightY = VectorSetFloat1(Query.Right.Y), RightZ = VectorSetFloat1(Query.Right.Z);
+	const auto UpX = VectorSetFloat1(Query.Up.X), UpY = VectorSetFloat1(Query.Up.Y), UpZ = VectorSetFloat1(Query.Up.Z);
+
+	// 세워진 캡슐을 각 축에 투영한 반지름은 Radius + Segment * |축.Z| 입니다.
+	const auto AbsDirZ = VectorSetFloat1(FMath::Abs(Query.Dir.Z));
+	const auto AbsRightZ = VectorSetFloat1(FMath::Abs(Query.Right.Z));
+	const auto AbsUpZ = VectorSetFloat1(FMath::Abs(Query.Up.Z));
+
+	const auto MaxDistance = VectorSetFloat1(Query.MaxDistance);
+	const auto BoxRight = VectorSetFloat1(Query.BoxSize.X);
+	const auto BoxUp = VectorSetFloat1(Query.BoxSize.Y);
+
+	MS_ALIGN(16) float Distances[4] GCC_ALIGN(16);
+
+	for (auto i = 0; i < Num; i += 4)
+	{
+		const auto DX = VectorSubtract(VectorLoadAligned(&Snapshot.X[i]), StartX);
+		const auto DY = VectorSubtract(VectorLoadAligned(&Snapshot.Y[i]), StartY);
+		const auto DZ = VectorSubtract(VectorLoadAligned(&Snapshot.Z[i]), StartZ);
+
+		const auto F = VectorMultiplyAdd(DZ, DirZ, VectorMultiplyAdd(DY, DirY, VectorMultiply(DX, DirX)));
+		const auto R = VectorAbs(VectorMultiplyAdd(DZ, RightZ, VectorMultiplyAdd(DY, RightY, VectorMultiply(DX, RightX))));
+		const auto U = VectorAbs(VectorMultiplyAdd(DZ, UpZ, VectorMultiplyAdd(DY, UpY, VectorMultiply(DX, UpX))));
+
+		const auto Rad = VectorLoadAligned(&Snapshot.Radius[i]);
+		const auto Seg = VectorLoadAligned(&Snapshot.Segment[i]);
+		const auto ExtF = VectorMultiplyAdd(Seg, AbsDirZ, Rad);
+		const auto ExtR = VectorMultiplyAdd(Seg, AbsRightZ, Rad);
+		const auto ExtU = VectorMultiplyAdd(Seg, AbsUpZ, Rad);
+
+		auto Mask = VectorCompareGE(F, VectorNegate(ExtF));
+		Mask = VectorBitwiseAnd(Mask, VectorCompareGE(VectorAdd(MaxDistance, ExtF), F));
+		Mask = VectorBitwiseAnd(Mask, VectorCompareGE(VectorAdd(BoxRight, ExtR), R));
+		Mask = VectorBitwiseAnd(Mask, VectorCompareGE(VectorAdd(BoxUp, ExtU), U));
+
+		auto Bits = VectorMaskBits(Mask);
+		if (!Bits) continue;
+
+		VectorStoreAligned(F, Distances);
+		for (auto k = 0; Bits; ++k, Bits >>= 1)
+			if ((Bits & 1) && i + k < Num)
+				OutCandidates.Add({Distances[k], Snapshot.Characters[i + k]});
+	}
+}
@@ -0,0 +1,359 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#include "Weapon/Ballistics.h"
+
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+// 고정점 반복으로 낮은 탄도의 해 근처까지 간 뒤 뉴턴 방법으로 좁힙니다.
+// 고정점 반복 없이 뉴턴 방법만 쓰면 사거리 끝에서 높은 탄도의 해로 가거나 발산하는 경우가 있습니다.
+static constexpr auto NumFixedPointSteps = 2;
+static constexpr auto NumNewtonSteps = 4;
+
+// 발사체가 간 거리와 목표까지의 거리가 이 비율 안에서 같아야 해로 인정합니다.
+static constexpr auto Tolerance = 1e-3f;
+
+void FBallisticTargets::Reset()
+{
+	X.Reset();
+	Y.Reset();
+	Z.Reset();
+	VX.Reset();
+	VY.Reset();
+	VZ.Reset();
+	NumTargets = 0;
+}
+
+void FBallisticTargets::Add(const FVector& Location, const FVector& Velocity)
+{
+	X.SetNum(NumTargets, false);
+	Y.SetNum(NumTargets, false);
+	Z.SetNum(NumTargets, false);
+	VX.SetNum(NumTargets, false);
+	VY.SetNum(NumTargets, false);
+	VZ.SetNum(NumTargets, false);
+
+	X.Add(Location.X);
+	Y.Add(Location.Y);
+	Z.Add(Location.Z);
+	VX.Add(Velocity.X);
+	VY.Add(Velocity.Y);
+	VZ.Add(Velocity.Z);
+	++NumTargets;
+}
+
+void FBallisticTargets::Pad()
+{
+	// 채워진 칸의 결과는 버려지므로 값은 상관없습니다.
+	const auto Padded = Align(NumTargets, 4);
+	for (auto Array : {&X, &Y, &Z, &VX, &VY, &VZ})
+	{
+		Array->SetNum(Padded, false);
+		for (auto i = NumTargets; i < Padded; ++i)
+			(*Array)[i] = 0.f;
+	}
+}
+
+bool Ballistics::Solve(const FVector& Start, const float Speed, const float GravityZ, const FVector& Location, const FVector& Velocity, FBallisticSolution& OutSolution)
+{
+	OutSolution.Time = -1.f;
+	OutSolution.Dir = (Location - Start).GetSafeNormal();
+	if (Speed <= 0.f) return false;
+
+	const auto D = Location - Start;
+	const FVector G{0.f, 0.f, GravityZ};
+	const auto SpeedSq = Speed * Speed;
+
+	// T초 뒤 목표의 위치에서 중력으로 떨어질 만큼을 미리 올려 둔 조준점까지의 변위
+	const auto Offset = [&](const float T) { return D + Velocity * T - G * (.5f * T * T); };
+
+	auto T = D.Size() / Speed;
+	for (auto i = 0; i < NumFixedPointSteps; ++i)
+		T = Offset(T).Size() / Speed;
+
+	for (auto i = 0; i < NumNewtonSteps; ++i)
+	{
+		const auto R = Offset(T);
+		const auto F = R.SizeSquared() - SpeedSq * T * T;
+		const auto DF = 2.f * ((R | (Velocity - G * T)) - SpeedSq * T);
+		T -= F / DF;
+	}
+
+	const auto R = Offset(T);
+	const auto Dist = R.Size();
+	if (!(T > 0.f) || !(FMath::Abs(Dist - Speed * T) <= Tolerance * Speed * T))
+		return false;
+
+	OutSolution.Dir = R / Dist;
+	OutSolution.Time = T;
+	return true;
+}
+
+void Ballistics::SolveBatch(const FVector& Start, const float Speed, const float GravityZ, const FBallisticTargets& Targets, TArray<FBallisticSolution>& OutSolutions)
+{
+	const auto Num = Targets.Num();
+	OutSolutions.SetNumUninitialized(Num);
+	if (Num == 0) return;
+	check(Targets.X.Num() % 4 == 0);
+
+	if (Speed <= 0.f)
+	{
+		for (auto i = 0; i < Num; ++i)
+			Solve(Start, Speed, GravityZ, {Targets.X[i], Targets.Y[i], Targets.Z[i]}, FVector::ZeroVector, OutSolutions[i]);
+		return;
+	}
+
+	const auto StartX = VectorSetFloat1(Start.X);
+	const auto StartY = VectorSetFloat1(Start.Y);
+	const auto StartZ = VectorSetFloat1(Start.Z);
+
+	const auto SpeedV = VectorSetFloat1(Speed);
+	const auto InvSpeed = VectorSetFloat1(1.f / Speed);
+	const auto SpeedSq = VectorSetFloat1(Speed * Speed);
+	const auto G = VectorSetFloat1(GravityZ);
+	const auto HalfG = VectorSetFloat1(.5f * GravityZ);
+	const auto Two = VectorSetFloat1(2.f);
+	const auto Tiny = VectorSetFloat1(SMALL_NUMBER);
+	const auto Tol = VectorSetFloat1(Tolerance * Speed);
+	const auto Invalid = VectorSetFloat1(-1.f);
+
+	const auto Dot = [](const VectorRegister& AX, const VectorRegister& AY, const VectorRegister& AZ,
+		const VectorRegister& BX, const VectorRegister& BY, const VectorRegister& BZ)
+	{
+		return VectorMultiplyAdd(AZ, BZ, VectorMultiplyAdd(AY, BY, VectorMultiply(AX, BX)));
+	};
+
+	const auto Length = [&](const VectorRegister& AX, const VectorRegister& AY, const VectorRegister& AZ)
+	{
+		const auto SizeSq = VectorMax(Dot(AX, AY, AZ, AX, AY, AZ), Tiny);
+		return VectorMultiply(SizeSq, VectorReciprocalSqrtAccurate(SizeSq));
+	};
+
+	MS_ALIGN(16) float Times[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float DirX[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float DirY[4] GCC_ALIGN(16);
+	MS_ALIGN(16) float DirZ[4] GCC_ALIGN(16);
+
+	for (auto i = 0; i < Num; i += 4)
+	{
+		const auto DX = VectorSubtract(VectorLoadAligned(&Targets.X[i]), StartX);
+		const auto DY = VectorSubtract(VectorLoadAligned(&Targets.Y[i]), StartY);
+		const auto DZ = VectorSubtract(VectorLoadAligned(&Targets.Z[i]), StartZ);
+		const auto VX = VectorLoadAligned(&Targets.VX[i]);
+		const auto VY = VectorLoadAligned(&Targets.VY[i]);
+		const auto VZ = VectorLoadAligned(&Targets.VZ[i]);
+
+		// 중력은 Z에만 있으므로 X, Y는 D + V*T 입니다.
+		const auto OffsetZ = [&](const VectorRegister& T)
+		{
+			return VectorSubtract(VectorMultiplyAdd(VZ, T, DZ), VectorMultiply(HalfG, VectorMultiply(T, T)));
+		};
+
+		auto T = VectorMultiply(Length(DX, DY, DZ), InvSpeed);
+		for (auto k = 0; k < NumFixedPointSteps; ++k)
+			T = VectorMultiply(Length(VectorMultiplyAdd(VX, T, DX), VectorMultiplyAdd(VY, T, DY), OffsetZ(T)), InvSpeed);
+
+		for (auto k = 0; k < NumNewtonSteps; ++k)
+		{
+			const auto RX = VectorMultiplyAdd(VX, T, DX);
+			const auto RY = VectorMultiplyAdd(VY, T, DY);
+			const auto RZ = OffsetZ(T);
+			const auto SpeedSqT = VectorMultiply(SpeedSq, T);
+			const auto F = VectorSubtract(Dot(RX, RY, RZ, RX, RY, RZ), VectorMultiply(SpeedSqT, T));
+			const auto DF = VectorMultiply(Two, VectorSubtract(Dot(RX, RY, RZ, VX, VY, VectorSubtract(VZ, VectorMultiply(G, T))), SpeedSqT));
+			T = VectorSubtract(T, VectorMultiply(F, VectorReciprocalAccurate(DF)));
+		}
+
+		const auto RX = VectorMultiplyAdd(VX, T, DX);
+		const auto RY = VectorMultiplyAdd(VY, T, DY);
+		const auto RZ = OffsetZ(T);
+		const auto Dist = Length(RX, RY, RZ);
+		const auto InvDist = VectorReciprocalAccurate(Dist);
+
+		// NaN은 어느 비교도 통과하지 못하므로 발산한 칸도 여기서 걸러집니다.
+		const auto Error = VectorAbs(VectorSubtract(Dist, VectorMultiply(SpeedV, T)));
+		const auto Valid = VectorBitwiseAnd(VectorCompareGT(T, VectorZero()), VectorCompareGE(VectorMultiply(Tol, T), Error));
+
+		VectorStoreAligned(VectorSelect(Valid, T, Invalid), Times);
+		VectorStoreAligned(VectorMultiply(RX, InvDist), DirX);
+		VectorStoreAligned(VectorMultiply(RY, InvDist), DirY);
+		VectorStoreAligned(VectorMultiply(RZ, InvDist), DirZ);
+
+		for (auto k = 0; k < 4 && i + k < Num; ++k)
+		{
+			auto& Solution = OutSolutions[i + k];
+			Solution.Time = Times[k];
+			Solution.Dir = Solution.IsValid()
+				? FVector{DirX[k], DirY[k], DirZ[k]}
+				: FVector{Targets.X[i + k] - Start.X, Targets.Y[i + k] - Start.Y, Targets.Z[i + k] - Start.Z}.GetSafeNormal();
+		}
+	}
+}
+
+#if !UE_BUILD_SHIPPING
+
+// AGun::Shoot에서 쓰던 삼각함수 근사. 벤치마크에서 비교하기 위해서만 남겨 둡니다.
+static FVector SolveLegacy(const FVector& MuzzleLoc, const FVector& Forward, const float ProjSpd, const FVector& Target, const FVector& EnemyVel)
+{
+	const auto PredictGravity = [&](const FVector& To)
+	{
+		const auto Theta = FMath::Asin(980.f*FVector::Dist(MuzzleLoc, To) / (ProjSpd*ProjSpd)) / 2;
+		return (To - MuzzleLoc).GetUnsafeNormal().RotateAngleAxis(FMath::RadiansToDegrees(Theta), Forward);
+	};
+
+	if (EnemyVel.IsNearlyZero()) return PredictGravity(Target);
+
+	const auto EnemyToMuzzle = MuzzleLoc - Target;
+	const auto Dot = EnemyToMuzzle.GetUnsafeNormal() | EnemyVel.GetUnsafeNormal();
+	const auto Alpha = FMath::Acos(Dot);
+	const auto EnemySpd = EnemyVel.Size();
+	const auto Theta = FMath::Asin(EnemySpd * FMath::Sin(Alpha) / ProjSpd);
+	const auto Time = EnemyToMuzzle.Size() / (EnemySpd*FMath::Cos(Alpha) + ProjSpd*FMath::Cos(Theta));
+	return PredictGravity(Target + EnemyVel * Time);
+}
+
+static void TestBallistics(const TArray<FString>&, FOutputDevice& Ar)
+{
+	struct FCase
+	{
+		const TCHAR* Name;
+		float Speed;
+		float GravityZ;
+		FVector Location;
+		FVector Velocity;
+
+		// 기대하는 해. Time이 음수면 풀 수 없어야 합니다.
+		FVector Dir;
+		float Time;
+	};
+
+	// 정해진 방향과 시간으로 쏜 발사체가 지나가는 점에 목표가 오도록 거꾸로 만든 경우들입니다.
+	const auto Make = [](const TCHAR* Name, const float Speed, const float GravityZ, const FVector& Dir, const float Time, const FVector& Velocity)
+	{
+		const auto Hit = Dir * Speed * Time + FVector{0.f, 0.f, .5f * GravityZ * Time * Time};
+		return FCase{Name, Speed, GravityZ, Hit - Velocity * Time, Velocity, Dir, Time};
+	};
+
+	const FCase Cases[] =
+	{
+		Make(TEXT("Stationary, no gravity"), 2000.f, 0.f, FVector::ForwardVector, .5f, FVector::ZeroVector),
+		Make(TEXT("Crossing, no gravity"), 2000.f, 0.f, FVector::ForwardVector, .5f, {0.f, 600.f, 0.f}),
+		Make(TEXT("Stationary, gravity, level"), 1500.f, -980.f, FRotator{15.f, 0.f, 0.f}.Vector(), .8f, FVector::ZeroVector),
+		Make(TEXT("Moving, gravity, climbing"), 1500.f, -980.f, FRotator{15.f, 0.f, 0.f}.Vector(), .8f, {0.f, 300.f, 100.f}),
+		Make(TEXT("Moving, gravity, downhill"), 1500.f, -980.f, FRotator{-20.f, 10.f, 0.f}.Vector(), .6f, {-200.f, 150.f, 0.f}),
+		Make(TEXT("Approaching, gravity"), 1000.f, -980.f, FRotator{5.f, -30.f, 0.f}.Vector(), .4f, {-400.f, 200.f, 0.f}),
+		{TEXT("Out of range"), 100.f, -980.f, {10000.f, 0.f, 0.f}, FVector::ZeroVector, FVector::ForwardVector, -1.f},
+	};
+
+	FBallisticTargets Targets;
+	for (auto&& Case : Cases) Targets.Add(Case.Location, Case.Velocity);
+	Targets.Pad();
+
+	auto NumFailed = 0;
+	for (auto i = 0; i < UE_ARRAY_COUNT(Cases); ++i)
+	{
+		auto&& Case = Cases[i];
+
+		FBallisticSolution Scalar;
+		Ballistics::Solve(FVector::ZeroVector, Case.Speed, Case.GravityZ, Case.Location, Case.Velocity, Scalar);
+
+		// 배치는 발사 속력과 중력이 같은 목표끼리 풀므로 경우마다 따로 돌립니다.
+		FBallisticTargets One;
+		One.Add(Case.Location, Case.Velocity);
+		One.Pad();
+		TArray<FBallisticSolution> Batch;
+		Ballistics::SolveBatch(FVector::ZeroVector, Case.Speed, Case.GravityZ, One, Batch);
+
+		const auto Check = [&](const FBallisticSolution& Solution)
+		{
+			if (Case.Time < 0.f) return !Solution.IsValid();
+			return Solution.IsValid() && FMath::IsNearlyEqual(Solution.Time, Case.Time, 1e-3f) && Solution.Dir.Equals(Case.Dir, 1e-3f);
+		};
+
+		const auto bPassed = Check(Scalar) && Check(Batch[0]);
+		if (!bPassed) ++NumFailed;
+
+		Ar.Logf(TEXT("%s %s: expected %.4fs %s, scalar %.4fs %s, batch %.4fs %s"),
+			bPassed ? TEXT("PASS") : TEXT("FAIL"), Case.Name,
+			Case.Time, *Case.Dir.ToString(),
+			Scalar.Time, *Scalar.Dir.ToString(),
+			Batch[0].Time, *Batch[0].Dir.ToString());
+	}
+
+	Ar.Logf(TEXT("Ballistics: %d/%d passed"), UE_ARRAY_COUNT(Cases) - NumFailed, UE_ARRAY_COUNT(Cases));
+}
+
+static void BenchmarkBallistics(const TArray<FString>& Args, FOutputDevice& Ar)
+{
+	const auto NumTargets = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 16;
+	const auto Iterations = Args.Num() > 1 ? FMath::Max(FCString::Atoi(*Args[1]), 1) : 10000;
+	constexpr auto Speed = 1500.f;
+	constexpr auto GravityZ = -980.f;
+
+	FRandomStream Random{0};
+	TArray<FVector> Locations, Velocities;
+	FBallisticTargets Targets;
+	for (auto i = 0; i < NumTargets; ++i)
+	{
+		Locations.Add({Random.FRandRange(200.f, 1500.f), Random.FRandRange(-800.f, 800.f), Random.FRandRange(-200.f, 200.f)});
+		Velocities.Add({Random.FRandRange(-500.f, 500.f), Random.FRandRange(-500.f, 500.f), 0.f});
+		Targets.Add(Locations.Last(), Velocities.Last());
+	}
+	Targets.Pad();
+
+	// 최적화로 계산이 사라지지 않도록 결과를 모읍니다.
+	FVector Sink = FVector::ZeroVector;
+
+	auto Start = FPlatformTime::Seconds();
+	for (auto It = 0; It < Iterations; ++It)
+		for (auto i = 0; i < NumTargets; ++i)
+			Sink += SolveLegacy(FVector::ZeroVector, FVector::ForwardVector, Speed, Locations[i], Velocities[i]);
+	const auto LegacyTime = FPlatformTime::Seconds() - Start;
+
+	FBallisticSolution Solution;
+	Start = FPlatformTime::Seconds();
+	for (auto It = 0; It < Iterations; ++It)
+	{
+		for (auto i = 0; i < NumTargets; ++i)
+		{
+			Ballistics::Solve(FVector::ZeroVector, Speed, GravityZ, Locations[i], Velocities[i], Solution);
+			Sink += Solution.Dir;
+		}
+	}
+	const auto ScalarTime = FPlatformTime::Seconds() - Start;
+
+	TArray<FBallisticSolution> Solutions;
+	Start = FPlatformTime::Seconds();
+	for (auto It = 0; It < Iterations; ++It)
+	{
+		Ballistics::SolveBatch(FVector::ZeroVector, Speed, GravityZ, Targets, Solutions);
+		Sink += Solutions[0].Dir;
+	}
+	const auto BatchTime = FPlatformTime::Seconds() - Start;
+
+	const auto NumOps = static_cast<double>(Iterations) * NumTargets;
+	Ar.Logf(TEXT("Ballistic lead: %d iterations x %d targets (%s)"), Iterations, NumTargets, *Sink.ToString());
+	Ar.Logf(TEXT("  Trigonometric (legacy): %8.3f ms (%6.1f ns/target)"), LegacyTime * 1e3, LegacyTime * 1e9 / NumOps);
+	Ar.Logf(TEXT("  Iterative scalar:       %8.3f ms (%6.1f ns/target)"), ScalarTime * 1e3, ScalarTime * 1e9 / NumOps);
+	Ar.Logf(TEXT("  Iterative SIMD batch:   %8.3f ms (%6.1f ns/target)"), BatchTime * 1e3, BatchTime * 1e9 / NumOps);
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice TestBallisticsCommand{
+	TEXT("Saucewich.Ballistics.Test"),
+	TEXT("Checks the ballistic lead solver against trajectories with known answers"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		TestBallistics(Args, Ar);
+	})
+};
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice BenchmarkBallisticsCommand{
+	TEXT("Saucewich.Ballistics.Bench"),
+	TEXT("Compares the legacy trigonometric lead against the iterative solver. Usage: Saucewich.Ballistics.Bench [Targets=16] [Iterations=10000]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda([](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		BenchmarkBallistics(Args, Ar);
+	})
+};
+
+#endif
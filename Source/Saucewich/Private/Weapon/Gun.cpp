@@ -2,29 +2,66 @@
 
 #include "Weapon/Gun.h"
 
+#include "Components/CapsuleComponent.h"
 #include "Components/StaticMeshComponent.h"
+#include "HAL/IConsoleManager.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Sound/SoundBase.h"
 
 #include "Entity/ActorPool.h"
 #include "Kismet/GameplayStatics.h"
+#include "GameMode/SaucewichBench.h"
 #include "GameMode/SaucewichGameState.h"
 #include "Player/TpsCharacter.h"
+#include "Weapon/Ballistics.h"
+#include "Weapon/HitboxHistory.h"
 #include "Weapon/WeaponComponent.h"
 #include "Weapon/Projectile/GunProjectile.h"
+#include "Weapon/Projectile/ProjectileSubsystem.h"
+#include "Saucewich.h"
 #include "UserSettings.h"
 #include "Names.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Reports Sent"), STAT_HitReportsSent, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Reports Accepted"), STAT_HitReportsAccepted, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Reports Rejected"), STAT_HitReportsRejected, STATGROUP_Saucewich);
+
+static TAutoConsoleVariable<float> CVarFixedStepRate{
+	TEXT("Saucewich.Gun.FixedStepRate"), 60.f,
+	TEXT("Number of fixed steps per second used for gun spread recovery and reloading")
+};
+
+static TAutoConsoleVariable<int32> CVarAutoAimSweep{
+	TEXT("Saucewich.AutoAim.Sweep"), 0,
+	TEXT("1: Auto aim uses a physics box sweep against all pawns (legacy)\n")
+	TEXT("0: Auto aim culls per-team capsule snapshots with SIMD and traces only the closest candidates")
+};
+
+static TAutoConsoleVariable<float> CVarGunTraceCacheTolerance{
+	TEXT("Saucewich.AutoAim.CacheTolerance"), .5f,
+	TEXT("GunTrace results are reused within a frame while the aim rotation stays within this many degrees")
+};
+
+static TAutoConsoleVariable<int32> CVarAutoAimMaxTraces{
+	TEXT("Saucewich.AutoAim.MaxTraces"), 3,
+	TEXT("Maximum number of line of sight traces per auto aim query")
+};
+
 AGun::AGun()
-	:FirePSC{CreateDefaultSubobject<UParticleSystemComponent>(Names::FirePSC)}
+	:FirePSC{Cosmetic::CreateSubobject<UParticleSystemComponent>(this, Names::FirePSC)}
 {
+	bDilatable = true;
 	PrimaryActorTick.bCanEverTick = true;
 
-	FirePSC->SetupAttachment(GetMesh(), Names::Muzzle);
-	FirePSC->bAutoActivate = false;
+	if (FirePSC)
+	{
+		FirePSC->SetupAttachment(GetMesh(), Names::Muzzle);
+		FirePSC->bAutoActivate = false;
+	}
 }
 
 const FGunData& AGun::GetGunDataFromClass(const TSubclassOf<AGun> Class)
@@ -32,58 +69,123 @@ const FGunData& AGun::GetGunDataFromClass(const TSubclassOf<AGun> Class)
 	return GetDefault<AGun>(Class)->GetGunData();
 }
 
+int32 AGun::EstimateLiveProjectiles(const TSubclassOf<AGun> Class)
+{
+	auto&& Data = GetGunDataFromClass(Class);
+	const auto ProjCls = Data.ProjectileClass.LoadSynchronous();
+	if (!ProjCls) return 0;
+
+	// 수명이 없는 발사체는 자동 조준 최대 거리까지 날아가는 시간만큼 산다고 봅니다.
+	auto LifeSpan = GetDefault<AActor>(ProjCls)->InitialLifeSpan;
+	if (LifeSpan <= 0.f) LifeSpan = Data.MaxDistance / FMath::Max(Data.ProjectileSpeed, 1.f);
+
+	return FMath::CeilToInt(Data.NumProjectile * Data.Rpm / 60.f * LifeSpan);
+}
+
 void AGun::Tick(const float DeltaSeconds)
 {
 	Super::Tick(DeltaSeconds);
 
 	auto&& Data = GetGunData();
 	const auto Delay = 60.f / Data.Rpm;
-	if (bFiring)
+	const auto Step = 1.f / FMath::Max(CVarFixedStepRate.GetValueOnGameThread(), 1.f);
+
+	const auto MuzzleTransform = GetMesh()->GetSocketTransform(Names::Muzzle);
+	const auto Rotation = GetActorQuat();
+	if (LastTransformFrame + 1 != GFrameCounter)
 	{
-		for (; FireLag >= Delay; FireLag -= Delay)
+		LastMuzzleTransform = MuzzleTransform;
+		LastRotation = Rotation;
+	}
+
+	// 이번 프레임을 고정 스텝 경계와 발사 시각으로 잘라 시간 순서대로 처리합니다.
+	// 프레임레이트가 달라도 발사, 탄퍼짐, 재장전이 같은 시각에 같은 순서로 계산되며,
+	// 한 프레임에 여러 발을 쏘더라도 각 발은 그 시각의 총구 위치에서 나갑니다.
+	FShotBatch Batch;
+	auto Remaining = DeltaSeconds;
+	for (;;)
+	{
+		const auto ToStep = Step - StepLag;
+		const auto ToShot = bFiring ? FMath::Max(Delay - FireLag, 0.f) : MAX_flt;
+		const auto Next = FMath::Min(ToStep, ToShot);
+		if (Next > Remaining) break;
+
+		Remaining -= Next;
+		StepLag += Next;
+		FireLag += Next;
+
+		if (ToShot <= ToStep)
 		{
-			Shoot();
+			FireLag -= Delay;
+			const auto Alpha = DeltaSeconds > 0.f ? 1.f - Remaining / DeltaSeconds : 1.f;
+			FTransform Muzzle;
+			Muzzle.Blend(LastMuzzleTransform, MuzzleTransform, Alpha);
+			Shoot(Batch, Muzzle, FQuat::Slerp(LastRotation, Rotation, Alpha), Remaining);
+		}
+		else
+		{
+			StepLag = 0.f;
+			FixedTick(Step);
 		}
 	}
-	else
+
+	StepLag += Remaining;
+	FireLag += Remaining;
+	if (!bFiring && FireLag > Delay) FireLag = Delay;
+
+	FlushShots(Batch);
+	if (!bFiring && FirePSC) FirePSC->Deactivate();
+
+	// 산탄 한 발의 발사체마다 신뢰성 RPC를 보내면 버퍼가 넘칠 수 있으므로 한 프레임의 명중 보고를 묶어 보냅니다.
+	if (PendingHitReports.Num() > 0)
 	{
-		SpreadAlpha = FMath::Clamp(SpreadAlpha - Data.SpreadDecrease*DeltaSeconds, Data.FirstSpreadRatio, 1.f);
-		FirePSC->Deactivate();
+		ServerReportHits(PendingHitReports);
+		PendingHitReports.Reset();
 	}
-	FireLag += DeltaSeconds;
-	if (!bFiring && FireLag > Delay) FireLag = Delay;
-	
-	Reload(DeltaSeconds);
+
+	LastMuzzleTransform = MuzzleTransform;
+	LastRotation = Rotation;
+	LastTransformFrame = GFrameCounter;
+}
+
+void AGun::FixedTick(const float Step)
+{
+	if (!bFiring)
+	{
+		auto&& Data = GetGunData();
+		SpreadAlpha = FMath::Clamp(SpreadAlpha - Data.SpreadDecrease*Step, Data.FirstSpreadRatio, 1.f);
+	}
+
+	Reload(Step);
 }
 
 void AGun::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(AGun, Clip);
-	DOREPLIFETIME(AGun, bDried);
-	DOREPLIFETIME(AGun, bFiring);
-	DOREPLIFETIME(AGun, bFreeze);
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AGun, Clip, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AGun, bDried, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AGun, bFiring, Params);
+	DOREPLIFETIME_WITH_PARAMS_FAST(AGun, bFreeze, Params);
 }
 
-void AGun::Shoot()
+void AGun::Shoot(FShotBatch& Batch, const FTransform& MuzzleTransform, const FQuat& Rotation, const float Age)
 {
 	if (!CanFire())
 	{
-		FirePSC->Deactivate();
+		if (FirePSC) FirePSC->Deactivate();
 		return;
 	}
 
 	auto&& Data = GetGunData();
 
-	const auto MuzzleTransform = GetMesh()->GetSocketTransform(Names::Muzzle);
 	const auto MuzzleLoc = MuzzleTransform.GetLocation();
+	const auto Forward = Rotation.GetAxisX();
+	const auto Right = Rotation.GetAxisY();
 
-	auto&& ActorTransform = GetActorTransform();
-	const auto Forward = ActorTransform.GetUnitAxis(EAxis::X);
-	const auto Right = ActorTransform.GetUnitAxis(EAxis::Y);
-
-	const auto ProjCls = Data.ProjectileClass.LoadSynchronous();
+	const auto ProjCls = GetProjectileClass();
 	const auto Proj = GetDefault<AGunProjectile>(ProjCls);
 	const auto ProjColProf = Proj->GetCollisionProfile();
 
@@ -91,30 +193,15 @@ void AGun::Shoot()
 	const auto bHit = GunTraceInternal(Hit, ProjColProf, Data);
 
 
+	// 닿을 수 없는 거리라면 (Solve가 실패하면) 맞은 위치를 바로 겨눕니다.
 	const auto Dir = [&]
 	{
 		if (!bHit) return MuzzleTransform.GetRotation().Vector();
 
-		const auto ProjSpd = Data.ProjectileSpeed;
-
-		const auto PredictGravity = [&](const FVector& To)
-		{
-			// 이 수치는 근사값인데, 고저차를 반영하지 못하기 때문이다.
-			const auto Theta = FMath::Asin(980.f*FVector::Dist(MuzzleLoc, To) / (ProjSpd*ProjSpd)) / 2;
-			return (To - MuzzleLoc).GetUnsafeNormal().RotateAngleAxis(FMath::RadiansToDegrees(Theta), Forward);
-		};
-		
-		const auto EnemyVel = Hit.GetActor()->GetVelocity();
-		if (EnemyVel.IsNearlyZero()) return PredictGravity(Hit.ImpactPoint);
-
-		const auto EnemyToMuzzle = MuzzleLoc - Hit.ImpactPoint;
-		const auto Dot = EnemyToMuzzle.GetUnsafeNormal() | EnemyVel.GetUnsafeNormal();
-		const auto Alpha = FMath::Acos(Dot);
-		const auto EnemySpd = EnemyVel.Size();
-		const auto Theta = FMath::Asin(EnemySpd * FMath::Sin(Alpha) / ProjSpd);
-		const auto Time = EnemyToMuzzle.Size() / (EnemySpd*FMath::Cos(Alpha) + ProjSpd*FMath::Cos(Theta));
-		const auto PredictedHitLocation = Hit.ImpactPoint + EnemyVel * Time;
-		return PredictGravity(PredictedHitLocation);
+		const auto GravityZ = Proj->GetMovement()->ProjectileGravityScale * GetWorld()->GetGravityZ();
+		FBallisticSolution Lead;
+		Ballistics::Solve(MuzzleLoc, Data.ProjectileSpeed, GravityZ, Hit.ImpactPoint, Hit.GetActor()->GetVelocity(), Lead);
+		return Lead.Dir;
 	}();
 
 	const auto V = 45.f * Data.VerticalSpread;
@@ -125,30 +212,33 @@ void AGun::Shoot()
 		FVector{FireRand.FRandRange(Data.MinProjectileSize, Data.MaxProjectileSize)}
 	};
 
-	FActorSpawnParameters Parameters;
-	Parameters.Owner = this;
-	Parameters.Instigator = GetInstigator();
-
 	for (auto i = 0; i < Data.NumProjectile; ++i)
 	{
 		const auto VR = FireRand.FRandRange(-V, V) * SpreadAlpha;
 		const auto HR = FireRand.FRandRange(-H, H) * SpreadAlpha;
 		SpawnTransform.SetRotation(Dir.RotateAngleAxis(VR, Forward).RotateAngleAxis(HR, Right).ToOrientationQuat());
-		AActorPool::Get(this)->Spawn<AGunProjectile>(ProjCls, SpawnTransform, Parameters);
+		Batch.Transforms.Add(SpawnTransform);
+		Batch.Ages.Add(Age);
 		SpreadAlpha = FMath::Min(SpreadAlpha + Data.SpreadIncrease, 1.f);
 	}
 
+	// 명중 보고는 발사한 발사체 수만큼만 받습니다. 보고되지 않은 빗나간 발사체가 쌓이지 않도록 몇 발 분량으로 제한합니다.
+	if (HasAuthority())
+		HitCredits = FMath::Min(HitCredits + Data.NumProjectile, Data.NumProjectile * 8);
+
 	LastClip = --Clip;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AGun, Clip, this);
 	OnRep_Clip();
 	if (!bDried && Clip == 0 && HasAuthority())
 	{
 		bDried = true;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AGun, bDried, this);
 		OnRep_Dried();
 	}
 	ReloadAlpha = 0.f;
 	ReloadWaitingTime = 0.f;
 
-	UGameplayStatics::PlaySoundAtLocation(this, Data.FireSound.LoadSynchronous(), MuzzleLoc);
+	UGameplayStatics::PlaySoundAtLocation(this, GetFireSound(), MuzzleLoc);
 
 	const auto PC = Cast<APlayerController>(GetInstigatorController());
 	if (PC && PC->IsLocalController())
@@ -156,44 +246,117 @@ void AGun::Shoot()
 		if (UUserSettings::Get(this)->bVibration)
 			PC->PlayDynamicForceFeedback(Data.FFBIntensity, Data.FFBDuration, true, false, true, false);
 
-		PC->ClientPlayCameraShake(Data.FireShake.LoadSynchronous(), Data.Recoil);
+		PC->ClientPlayCameraShake(GetFireShake(), Data.Recoil);
 	}
 
-	FirePSC->Activate();
+	if (FirePSC) FirePSC->Activate();
 
 	OnShoot();
 }
 
+void AGun::FlushShots(const FShotBatch& Batch)
+{
+	if (Batch.Transforms.Num() == 0) return;
+
+	FActorSpawnParameters Parameters;
+	Parameters.Owner = this;
+	Parameters.Instigator = GetInstigator();
+
+	const auto ProjCls = GetProjectileClass();
+	if (UProjectileSubsystem::IsEnabled())
+	{
+		UProjectileSubsystem::Get(this)->Fire(this, ProjCls, Batch.Transforms, Parameters, Batch.Ages);
+	}
+	else
+	{
+		// 액터가 직접 움직이는 발사체는 발사 시각을 반영하지 않고 보간된 총구 위치에서만 나갑니다.
+		TArray<APoolActor*, TInlineAllocator<16>> Projectiles;
+		AActorPool::Get(this)->SpawnBatch(ProjCls, Batch.Transforms, Parameters, Projectiles);
+	}
+}
+
 bool AGun::GunTrace(FHitResult& OutHit)
 {
 	auto& Data = GetGunData();
-	const auto Cls = Data.ProjectileClass.LoadSynchronous();
-	const auto Def = GetDefault<AProjectile>(Cls);
+	const auto Def = GetDefault<AProjectile>(GetProjectileClass());
 	const auto Profile = Def->GetCollisionProfile();
 	return GunTraceInternal(OutHit, Profile, Data);
 }
 
+template <class T, class TSoftPtr>
+static const T& Resolve(T& Cache, const TSoftPtr& Soft, const AGun* const Gun)
+{
+	if (!Cache) Cache = SyncLoad::Load(Soft, Gun);
+	return Cache;
+}
+
+TSubclassOf<AGunProjectile> AGun::GetProjectileClass() const
+{
+	return Resolve(ProjectileClass, GetGunData().ProjectileClass, this);
+}
+
+TSubclassOf<UDamageType> AGun::GetDamageType() const
+{
+	return Resolve(DamageType, GetGunData().DamageType, this);
+}
+
+USoundBase* AGun::GetFireSound() const
+{
+	return Resolve(FireSound, GetGunData().FireSound, this);
+}
+
+TSubclassOf<UCameraShake> AGun::GetFireShake() const
+{
+	return Resolve(FireShake, GetGunData().FireShake, this);
+}
+
 DECLARE_CYCLE_STAT(TEXT("GunTrace"), STAT_GunTrace, STATGROUP_Game)
+DECLARE_DWORD_COUNTER_STAT(TEXT("GunTrace Cache Hits"), STAT_GunTraceCacheHits, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("GunTrace Cache Misses"), STAT_GunTraceCacheMisses, STATGROUP_Saucewich);
+
 bool AGun::GunTraceInternal(FHitResult& OutHit, const FName ProjColProf, const FGunData& Data)
 {
-	SCOPE_CYCLE_COUNTER(STAT_GunTrace);
-	
 	const auto Character = CastChecked<ATpsCharacter>(GetOwner(), ECastCheckedType::NullAllowed);
 	if (!IsValid(Character)) return false;
-	
+
+	const auto Aim = Character->GetBaseAimRotation();
+	if (TraceCache.bValid && TraceCache.Frame == GFrameCounter
+		&& TraceCache.Aim.Equals(Aim, CVarGunTraceCacheTolerance.GetValueOnGameThread()))
+	{
+		INC_DWORD_STAT(STAT_GunTraceCacheHits);
+		if (TraceCache.bHit) OutHit = TraceCache.Hit;
+		return TraceCache.bHit;
+	}
+
+	INC_DWORD_STAT(STAT_GunTraceCacheMisses);
+	SCOPE_CYCLE_COUNTER(STAT_GunTrace);
+
+	const auto bHit = CVarAutoAimSweep.GetValueOnGameThread()
+		? GunTraceSweep(OutHit, Data, Character)
+		: GunTraceCull(OutHit, Data, Character);
+
+	TraceCache.Frame = GFrameCounter;
+	TraceCache.Aim = Aim;
+	TraceCache.bHit = bHit;
+	TraceCache.bValid = true;
+	if (bHit) TraceCache.Hit = OutHit;
+
+	return bHit;
+}
+
+bool AGun::GunTraceSweep(FHitResult& OutHit, const FGunData& Data, const ATpsCharacter* const Character)
+{
 	const auto AimRotation = Character->GetBaseAimRotation();
 	const auto AimDir = AimRotation.Vector();
 	const auto Start = Character->GetSpringArmLocation() + AimDir * 10.f;
 	const auto Offset = AimDir * Data.MaxDistance;
 	const auto End = Start + Offset;
 
-	FCollisionQueryParams Params;
-	if (const auto GS = CastChecked<ASaucewichGameState>(GetWorld()->GetGameState(), ECastCheckedType::NullAllowed))
-	{
-		Params.AddIgnoredActors(TArray<AActor*>{GS->GetCharactersByTeam(Character->GetTeam())});
-	}
+	const auto GS = CastChecked<ASaucewichGameState>(GetWorld()->GetGameState(), ECastCheckedType::NullAllowed);
+	auto&& Params = GS ? GS->GetTeamIgnoreParams(Character->GetTeam()) : FCollisionQueryParams::DefaultQueryParam;
 
 	TArray<FHitResult> BoxHits;
+	SaucewichBench::CountTraces();
 	GetWorld()->SweepMultiByProfile(
 		BoxHits, Start, End, AimRotation.Quaternion(), NAME("PawnOnly"),
 		FCollisionShape::MakeBox({ 0.f, Data.TraceBoxSize.X, Data.TraceBoxSize.Y }), Params
@@ -204,9 +367,10 @@ bool AGun::GunTraceInternal(FHitResult& OutHit, const FName ProjColProf, const F
 	{
 		const auto Chr = Cast<APawn>(BoxHits[i].GetActor());
 		if (!Chr || !Chr->ShouldTakeDamage(Data.Damage, FPointDamageEvent{
-			Data.Damage, BoxHits[i], (End-Start).GetSafeNormal(), Data.DamageType.LoadSynchronous()
+			Data.Damage, BoxHits[i], (End-Start).GetSafeNormal(), GetDamageType()
 		}, GetInstigatorController(), this)) continue;
 
+		SaucewichBench::CountTraces();
 		if (!GetWorld()->LineTraceTestByProfile(BoxHits[i].ImpactPoint, Start, NAME("NoPawn"), Params))
 		{
 			HitPawn = i;
@@ -223,6 +387,92 @@ bool AGun::GunTraceInternal(FHitResult& OutHit, const FName ProjColProf, const F
 	return false;
 }
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("AutoAim Candidates"), STAT_AutoAimCandidates, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AutoAim LOS Traces"), STAT_AutoAimLOSTraces, STATGROUP_Saucewich);
+
+ATpsCharacter* AGun::FindAutoAimCandidate() const
+{
+	FAutoAimQuery Query;
+	FAutoAimCandidates Candidates;
+	return CullAutoAim(Query, Candidates) ? Candidates[0].Character : nullptr;
+}
+
+bool AGun::CullAutoAim(FAutoAimQuery& OutQuery, FAutoAimCandidates& OutCandidates) const
+{
+	const auto Character = CastChecked<ATpsCharacter>(GetOwner(), ECastCheckedType::NullAllowed);
+	if (!IsValid(Character)) return false;
+
+	const auto GS = CastChecked<ASaucewichGameState>(GetWorld()->GetGameState(), ECastCheckedType::NullAllowed);
+	if (!GS) return false;
+
+	auto&& Data = GetGunData();
+	const FRotationMatrix AimMatrix{Character->GetBaseAimRotation()};
+
+	OutQuery.Dir = AimMatrix.GetUnitAxis(EAxis::X);
+	OutQuery.Right = AimMatrix.GetUnitAxis(EAxis::Y);
+	OutQuery.Up = AimMatrix.GetUnitAxis(EAxis::Z);
+	OutQuery.Start = Character->GetSpringArmLocation() + OutQuery.Dir * 10.f;
+	OutQuery.MaxDistance = Data.MaxDistance;
+	OutQuery.BoxSize = Data.TraceBoxSize;
+
+	const auto MyTeam = Character->GetTeam();
+	for (auto Team = 0; Team < GS->GetNumTeams(); ++Team)
+		if (Team != MyTeam)
+			AutoAim::Cull(GS->GetAutoAimSnapshot(Team), OutQuery, OutCandidates);
+
+	if (OutCandidates.Num() == 0) return false;
+	OutCandidates.Sort();
+	return true;
+}
+
+bool AGun::GunTraceCull(FHitResult& OutHit, const FGunData& Data, const ATpsCharacter* const Character)
+{
+	FAutoAimQuery Query;
+	FAutoAimCandidates Candidates;
+	if (!CullAutoAim(Query, Candidates)) return false;
+	INC_DWORD_STAT_BY(STAT_AutoAimCandidates, Candidates.Num());
+
+	const auto End = Query.Start + Query.Dir * Query.MaxDistance;
+	const FCollisionQueryParams Params{SCENE_QUERY_STAT(AutoAimLOS), false, Character};
+
+	// 물리 쿼리는 가장 가까운 후보 몇 명에게만 합니다.
+	const auto MaxTraces = FMath::Min(Candidates.Num(), CVarAutoAimMaxTraces.GetValueOnGameThread());
+	for (auto i = 0; i < MaxTraces; ++i)
+	{
+		const auto Target = Candidates[i].Character;
+		const auto Capsule = Target->GetCapsuleComponent();
+		const auto Center = Capsule->GetComponentLocation();
+		float Radius, HalfHeight;
+		Capsule->GetScaledCapsuleSize(Radius, HalfHeight);
+
+		// 조준선에서 캡슐 중심에 가장 가까운 점을 캡슐의 경계 상자 안으로 가져와서 맞은 위치로 씁니다.
+		const auto Closest = Query.Start + Query.Dir * FMath::Max(Candidates[i].Distance, 0.f);
+		const FVector Extent{Radius, Radius, HalfHeight};
+		const auto ImpactPoint = Center + (Closest - Center).BoundToBox(-Extent, Extent);
+
+		FHitResult Hit{Target, Capsule, ImpactPoint, -Query.Dir};
+		Hit.bBlockingHit = true;
+		Hit.TraceStart = Query.Start;
+		Hit.TraceEnd = End;
+		Hit.Distance = Candidates[i].Distance;
+		Hit.Time = Hit.Distance / Query.MaxDistance;
+
+		if (!Target->ShouldTakeDamage(Data.Damage, FPointDamageEvent{
+			Data.Damage, Hit, Query.Dir, GetDamageType()
+		}, GetInstigatorController(), this)) continue;
+
+		INC_DWORD_STAT(STAT_AutoAimLOSTraces);
+		SaucewichBench::CountTraces();
+		if (!GetWorld()->LineTraceTestByProfile(ImpactPoint, Query.Start, NAME("NoPawn"), Params))
+		{
+			OutHit = Hit;
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void AGun::OnRep_Dried() const
 {
 	OnAvailabilityChanged(!bDried);
@@ -238,19 +488,33 @@ const FGunData& AGun::GetGunData() const
 	return GetData<FGunData>();
 }
 
+void AGun::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+	Cosmetic::Strip(this, FirePSC);
+}
+
 void AGun::BeginPlay()
 {
 	Super::BeginPlay();
 
-	const auto GS = CastChecked<ASaucewichGameState>(GetWorld()->GetGameState());
-	GS->AddDilatableActor(this);
-
-	GS->AddDilatablePSC(FirePSC);
-	FirePSC->SetFloatParameter(Names::RPM, GetData<FGunData>().Rpm);
+	// FirePSC는 총의 컴포넌트이므로 총의 시간 배율을 그대로 따릅니다.
+	if (FirePSC)
+	{
+		FirePSC->SetFloatParameter(Names::RPM, GetData<FGunData>().Rpm);
+	}
 }
 
 void AGun::FireP()
 {
+	// 입력 상태를 주고받는다면 시드는 무기 컴포넌트가 이미 정해 두었습니다.
+	if (UWeaponComponent::IsInputStreamEnabled())
+	{
+		if (const auto Character = Cast<ATpsCharacter>(GetOwner()))
+			StartFire(Character->GetWeaponComponent()->GetFireSeed());
+		return;
+	}
+
 	const auto Pawn = Cast<APawn>(GetOwner());
 	if (Pawn && Pawn->IsLocallyControlled())
 	{
@@ -263,6 +527,7 @@ void AGun::FireP()
 void AGun::FireR()
 {
 	bFiring = false;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AGun, bFiring, this);
 }
 
 void AGun::SlotP()
@@ -275,6 +540,7 @@ void AGun::OnActivated()
 {
 	Super::OnActivated();
 	Clip = GetGunData().ClipSize;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AGun, Clip, this);
 	OnRep_Clip();
 }
 
@@ -283,21 +549,47 @@ void AGun::OnReleased()
 	Super::OnReleased();
 	bFiring = false;
 	FireLag = 0.f;
+	StepLag = 0.f;
+	LastTransformFrame = 0;
 	bDried = false;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AGun, bFiring, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(AGun, bDried, this);
 	ReloadWaitingTime = 0.f;
+	HitCredits = 0;
+	PendingHitReports.Reset();
+	TraceCache.bValid = false;
 	OnClipChanged.Clear();
 }
 
+void AGun::GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const
+{
+	auto&& Data = GetGunData();
+	OutPaths.Add(Data.ProjectileClass.ToSoftObjectPath());
+	OutPaths.Add(Data.DamageType.ToSoftObjectPath());
+	OutPaths.Add(Data.FireSound.ToSoftObjectPath());
+	OutPaths.Add(Data.FireShake.ToSoftObjectPath());
+}
+
+void AGun::OnAssetsLoaded()
+{
+	auto&& Data = GetGunData();
+	ProjectileClass = Data.ProjectileClass.Get();
+	DamageType = Data.DamageType.Get();
+	FireSound = Data.FireSound.Get();
+	FireShake = Data.FireShake.Get();
+}
+
 void AGun::SetColor(const FLinearColor& NewColor)
 {
 	Super::SetColor(NewColor);
-	FirePSC->SetColorParameter(Names::Color, NewColor);
+	if (FirePSC) FirePSC->SetColorParameter(Names::Color, NewColor);
 }
 
 void AGun::StartFire(const int32 RandSeed)
 {
 	FireRand.Initialize(RandSeed);
 	bFiring = true;
+	MARK_PROPERTY_DIRTY_FROM_NAME(AGun, bFiring, this);
 }
 
 void AGun::MulticastStartFire_Implementation(const int32 RandSeed)
@@ -308,6 +600,7 @@ void AGun::MulticastStartFire_Implementation(const int32 RandSeed)
 
 void AGun::ServerStartFire_Implementation(const int32 RandSeed)
 {
+	SaucewichBench::CountInputMessages(2);
 	MulticastStartFire(RandSeed);
 }
 
@@ -316,6 +609,53 @@ bool AGun::ServerStartFire_Validate(int32)
 	return true;
 }
 
+void AGun::ReportHit(const FHitResult& Hit, const FVector& Direction)
+{
+	const auto Victim = Cast<ATpsCharacter>(Hit.GetActor());
+	if (!Victim) return;
+
+	FGunHitReport Report;
+	Report.Victim = Victim;
+	Report.ImpactPoint = Hit.ImpactPoint;
+	Report.Direction = Direction;
+	Report.HitTime = GetWorld()->GetGameState()->GetServerWorldTimeSeconds();
+
+	INC_DWORD_STAT(STAT_HitReportsSent);
+	PendingHitReports.Add(Report);
+}
+
+void AGun::ServerReportHits_Implementation(const TArray<FGunHitReport>& Reports)
+{
+	for (auto&& Report : Reports) ApplyHitReport(Report);
+}
+
+bool AGun::ServerReportHits_Validate(const TArray<FGunHitReport>&)
+{
+	return true;
+}
+
+void AGun::ApplyHitReport(const FGunHitReport& Report)
+{
+	// 클라이언트 명중을 끈 서버는 자신의 시뮬레이션으로 이미 데미지를 주므로, 보고까지 받으면 두 번 맞게 됩니다.
+	const auto Victim = Report.Victim;
+	if (!UHitboxHistory::IsEnabled() || HitCredits == 0 || !IsValid(Victim) || !UHitboxHistory::Get(this)->Validate(Victim, Report.HitTime, Report.ImpactPoint))
+	{
+		INC_DWORD_STAT(STAT_HitReportsRejected);
+		return;
+	}
+
+	--HitCredits;
+	INC_DWORD_STAT(STAT_HitReportsAccepted);
+
+	// 거리에 따른 데미지 감소는 클라이언트가 보낸 값을 믿지 않고 총구에서 명중 지점까지의 거리로 계산합니다.
+	auto&& Data = GetGunData();
+	const auto Dist = FVector::Dist(GetMesh()->GetSocketLocation(Names::Muzzle), Report.ImpactPoint);
+	const auto TravelTime = Dist / FMath::Max(Data.ProjectileSpeed, 1.f);
+
+	FHitResult Hit{Victim, Victim->GetCapsuleComponent(), Report.ImpactPoint, -Report.Direction};
+	AGunProjectile::ApplyDamage(*this, TravelTime, Hit, Report.Direction);
+}
+
 bool AGun::CanFire() const
 {
 	return !bFreeze && IsActive() && Clip > 0 && !bDried;
@@ -332,12 +672,18 @@ void AGun::Reload(const float DeltaSeconds)
 		if (ReloadWaitingTime >= (bDried ? Data.ReloadWaitTimeAfterDried : Data.ReloadWaitTime))
 		{
 			ReloadAlpha = FMath::Clamp(ReloadAlpha + DeltaSeconds / Data.ReloadTime, 0.f, 1.f);
-			Clip = FMath::CubicInterp<float>(LastClip, 0.f, Data.ClipSize, 0.f, ReloadAlpha);
-			OnRep_Clip();
+			const uint8 NewClip = FMath::CubicInterp<float>(LastClip, 0.f, Data.ClipSize, 0.f, ReloadAlpha);
+			if (Clip != NewClip)
+			{
+				Clip = NewClip;
+				MARK_PROPERTY_DIRTY_FROM_NAME(AGun, Clip, this);
+				OnRep_Clip();
+			}
 
 			if (bDried && Clip >= Data.MinClipToFireAfterDried)
 			{
 				bDried = false;
+				MARK_PROPERTY_DIRTY_FROM_NAME(AGun, bDried, this);
 				OnRep_Dried();
 			}
 		}
@@ -0,0 +1,140 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#include "Weapon/HitboxHistory.h"
+
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+#include "GameMode/SaucewichGameState.h"
+#include "Player/TpsCharacter.h"
+#include "Saucewich.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hitbox History"), STAT_HitboxHistory, STATGROUP_Saucewich);
+
+static TAutoConsoleVariable<int32> CVarClientHits{
+	TEXT("Saucewich.LagComp.ClientHits"), 1,
+	TEXT("1: Remote players' gun hits on characters are reported by their client and validated against hitbox history\n")
+	TEXT("0: The server applies all gun damage from its own projectile simulation")
+};
+
+static TAutoConsoleVariable<float> CVarMaxRewind{
+	TEXT("Saucewich.LagComp.MaxRewind"), .4f,
+	TEXT("Maximum age in seconds of a reported hit the server accepts")
+};
+
+static TAutoConsoleVariable<float> CVarMaxLead{
+	TEXT("Saucewich.LagComp.MaxLead"), .05f,
+	TEXT("How far in seconds a reported hit may lie ahead of the server time, to absorb clock estimation error")
+};
+
+static TAutoConsoleVariable<float> CVarTolerance{
+	TEXT("Saucewich.LagComp.Tolerance"), 30.f,
+	TEXT("Distance a reported impact point may lie outside the rewound capsule")
+};
+
+UHitboxHistory* UHitboxHistory::Get(const UObject* const WorldContextObject)
+{
+	return WorldContextObject->GetWorld()->GetSubsystem<UHitboxHistory>();
+}
+
+bool UHitboxHistory::IsEnabled()
+{
+	return CVarClientHits.GetValueOnGameThread() != 0;
+}
+
+bool UHitboxHistory::Validate(const ATpsCharacter* const Victim, const float Time, const FVector& Point) const
+{
+	const auto Track = Tracks.Find(Victim);
+	if (!Track) return false;
+
+	const auto GS = GetWorld()->GetGameState();
+	const auto Now = GS ? GS->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	if (Time < Now - CVarMaxRewind.GetValueOnGameThread()) return false;
+
+	// 미래 시각이면 Find가 가장 최근 샘플을 돌려주므로 언제나 현재 캡슐과 비교하게 됩니다.
+	if (Time > Now + CVarMaxLead.GetValueOnGameThread()) return false;
+
+	FVector Location;
+	if (!Track->Find(Time, Location)) return false;
+
+	const FVector Segment{0.f, 0.f, Track->Segment};
+	const auto Dist = FMath::PointDistToSegment(Point, Location - Segment, Location + Segment);
+	return Dist <= Track->Radius + CVarTolerance.GetValueOnGameThread();
+}
+
+void UHitboxHistory::Tick(float)
+{
+	SCOPE_CYCLE_COUNTER(STAT_HitboxHistory);
+
+	const auto GS = GetWorld()->GetGameState<ASaucewichGameState>();
+	if (!GS) return;
+
+	const auto Now = GS->GetServerWorldTimeSeconds();
+	const auto Frame = GFrameCounter;
+
+	for (auto Team = 0; Team < GS->GetNumTeams(); ++Team)
+	{
+		for (const auto Character : GS->GetTeamCharacters(Team))
+		{
+			if (!Character->IsAlive()) continue;
+
+			const auto Capsule = Character->GetCapsuleComponent();
+			auto& Track = Tracks.FindOrAdd(Character);
+			float HalfHeight;
+			Capsule->GetScaledCapsuleSize(Track.Radius, HalfHeight);
+			Track.Segment = FMath::Max(HalfHeight - Track.Radius, 0.f);
+			Track.Frame = Frame;
+			Track.Add(Now, Capsule->GetComponentLocation());
+		}
+	}
+
+	// 죽었거나 팀에서 빠진 캐릭터의 기록은 버립니다. 리스폰한 캐릭터는 새 기록으로 시작합니다.
+	for (auto It = Tracks.CreateIterator(); It; ++It)
+		if (It.Value().Frame != Frame) It.RemoveCurrent();
+}
+
+bool UHitboxHistory::IsTickable() const
+{
+	const auto World = GetWorld();
+	return World && World->GetNetMode() != NM_Client && World->GetNetMode() != NM_Standalone && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UHitboxHistory::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHitboxHistory, STATGROUP_Tickables);
+}
+
+void UHitboxHistory::FTrack::Add(const float Time, const FVector& Location)
+{
+	Samples[Head] = {Time, Location};
+	Head = (Head + 1) % NumSamples;
+	Num = FMath::Min(Num + 1, NumSamples);
+}
+
+bool UHitboxHistory::FTrack::Find(const float Time, FVector& OutLocation) const
+{
+	if (Num == 0) return false;
+
+	// 최신 기록부터 거슬러 올라가며 Time을 감싸는 두 기록을 보간합니다.
+	auto Newer = &Samples[(Head + NumSamples - 1) % NumSamples];
+	if (Time >= Newer->Time)
+	{
+		OutLocation = Newer->Location;
+		return true;
+	}
+
+	for (auto i = 2; i <= Num; ++i)
+	{
+		const auto Older = &Samples[(Head + NumSamples - i) % NumSamples];
+		if (Time >= Older->Time)
+		{
+			const auto Alpha = (Time - Older->Time) / FMath::Max(Newer->Time - Older->Time, KINDA_SMALL_NUMBER);
+			OutLocation = FMath::Lerp(Older->Location, Newer->Location, Alpha);
+			return true;
+		}
+		Newer = Older;
+	}
+
+	return false;
+}
@@ -3,6 +3,7 @@
 #include "Weapon/Projectile/ExplosiveProjectile.h"
 
 #include "Kismet/GameplayStatics.h"
+#include "Saucewich.h"
 
 void AExplosiveProjectile::OnExplode(const FHitResult& Hit)
 {
@@ -18,12 +19,22 @@ void AExplosiveProjectile::OnExplode(const FHitResult& Hit)
 		false,
 		DamagePreventionChannel
 	);
-	
-	UGameplayStatics::PlayWorldCameraShake(this, CameraShake.LoadSynchronous(), Hit.Location, 0.f, Radius * 2.5f);
 
 	Super::OnExplode(Hit);
 }
 
+void AExplosiveProjectile::PlayImpactEffects(const AActor* const Context, const FHitResult& Hit, const FVector& Location, const uint8 EffectTeam) const
+{
+	UGameplayStatics::PlayWorldCameraShake(Context, SyncLoad::Load(CameraShake, Context), Hit.Location, 0.f, Radius * 2.5f);
+	Super::PlayImpactEffects(Context, Hit, Location, EffectTeam);
+}
+
+void AExplosiveProjectile::GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const
+{
+	Super::GetAssetsToLoad(OutPaths);
+	OutPaths.Add(CameraShake.ToSoftObjectPath());
+}
+
 float AExplosiveProjectile::GetSauceMarkScale() const
 {
 	return Radius / 75.f;
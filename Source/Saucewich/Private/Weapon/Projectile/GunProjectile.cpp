@@ -2,28 +2,56 @@
 
 #include "Weapon/Projectile/GunProjectile.h"
 #include "Components/StaticMeshComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Player/TpsCharacter.h"
 #include "Weapon/Gun.h"
+#include "Weapon/HitboxHistory.h"
+#include "Weapon/Projectile/ProjectileSubsystem.h"
+
+AGunProjectile::AGunProjectile()
+{
+	// 모든 기기가 같은 시드로 직접 시뮬레이션하므로 리플리케이트하지 않습니다.
+	bReplicates = false;
+}
 
 void AGunProjectile::OnExplode(const FHitResult& Hit)
 {
-	if (const auto Other = Hit.GetActor())
-	{
-		auto&& Data = CastChecked<AGun>(GetOwner())->GetGunData();
-		const auto ElapsedTime = GetGameTimeSinceCreation() - FiredTime;
-		const auto TravelDist = Data.ProjectileSpeed * ElapsedTime;
-		const FVector2D FireRange{Data.DmgFalloffStartDist, Data.DmgFalloffEndDist};
-		const auto Damage = FMath::GetMappedRangeValueClamped(FireRange, {Data.Damage, Data.MinDmg}, TravelDist);
-		Other->TakeDamage(
-			Damage,
-			FPointDamageEvent{Damage, Hit, GetVelocity().GetSafeNormal(), Data.DamageType.LoadSynchronous()},
-			GetInstigatorController(),
-			GetOwner()
-		);
-	}
-	
+	HandleImpact(*CastChecked<AGun>(GetOwner()), GetGameTimeSinceCreation() - FiredTime, Hit, GetVelocity().GetSafeNormal());
 	Super::OnExplode(Hit);
 }
 
+void AGunProjectile::ApplyDamage(AGun& Gun, const float TravelTime, const FHitResult& Hit, const FVector& Direction)
+{
+	const auto Other = Hit.GetActor();
+	if (!Other) return;
+
+	auto&& Data = Gun.GetGunData();
+	const auto TravelDist = Data.ProjectileSpeed * TravelTime;
+	const FVector2D FireRange{Data.DmgFalloffStartDist, Data.DmgFalloffEndDist};
+	const auto Damage = FMath::GetMappedRangeValueClamped(FireRange, {Data.Damage, Data.MinDmg}, TravelDist);
+	Other->TakeDamage(
+		Damage,
+		FPointDamageEvent{Damage, Hit, Direction, Gun.GetDamageType()},
+		Gun.GetInstigatorController(),
+		&Gun
+	);
+}
+
+void AGunProjectile::HandleImpact(AGun& Gun, const float TravelTime, const FHitResult& Hit, const FVector& Direction)
+{
+	const auto Pawn = Gun.GetInstigator();
+	const auto bLocal = Pawn && Pawn->IsLocallyControlled();
+	const auto bVictim = Hit.GetActor() && Hit.GetActor()->IsA<ATpsCharacter>();
+	const auto bClientHits = bVictim && UHitboxHistory::IsEnabled();
+
+	// 클라이언트에서의 데미지는 HP를 바꾸지 않고 피격 연출만 합니다.
+	if (!bClientHits || bLocal || !Gun.HasAuthority())
+		ApplyDamage(Gun, TravelTime, Hit, Direction);
+
+	if (bClientHits && bLocal && !Gun.HasAuthority())
+		Gun.ReportHit(Hit, Direction);
+}
+
 float AGunProjectile::GetSauceMarkScale() const
 {
 	auto&& S = GetMesh()->GetRelativeScale3D();
@@ -39,6 +67,26 @@ void AGunProjectile::OnActivated()
 	FiredTime = GetGameTimeSinceCreation();
 }
 
+void AGunProjectile::OnReleased()
+{
+	if (SimIndex != INDEX_NONE)
+		UProjectileSubsystem::Get(this)->DetachVisual(SimIndex);
+
+	GetMovement()->SetComponentTickEnabled(true);
+	Super::OnReleased();
+}
+
+void AGunProjectile::AttachToSimulation(const int32 Index)
+{
+	SimIndex = Index;
+	GetMovement()->SetUpdatedComponent(nullptr);
+	GetMovement()->SetComponentTickEnabled(false);
+	SetActorEnableCollision(false);
+
+	// 수명은 UProjectileSubsystem이 관리합니다.
+	SetLifeSpan(0.f);
+}
+
 void AGunProjectile::NotifyHit(UPrimitiveComponent* const MyComp, AActor* const Other, UPrimitiveComponent* const OtherComp, const bool bSelfMoved,
 	const FVector HitLocation, const FVector HitNormal, const FVector NormalImpulse, const FHitResult& Hit)
 {
@@ -5,6 +5,7 @@
 #include "Components/StaticMeshComponent.h"
 #include "GameFramework/ForceFeedbackAttenuation.h"
 #include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Particles/ParticleSystem.h"
@@ -14,15 +15,24 @@
 
 #include "Entity/SauceMarker.h"
 #include "GameMode/SaucewichGameState.h"
+#include "GameMode/SaucewichBench.h"
 #include "GameMode/SaucewichGameMode.h"
 #include "Player/TpsCharacter.h"
+#include "Saucewich.h"
 #include "UserSettings.h"
 #include "Names.h"
 
+static TAutoConsoleVariable<int32> CVarBatchImpacts{
+	TEXT("Saucewich.Net.BatchImpacts"), 1,
+	TEXT("1: Replicated projectile impacts are gathered by the game state and sent in one unreliable multicast per frame\n")
+	TEXT("0: Each impact is sent in its own reliable multicast")
+};
+
 AProjectile::AProjectile()
 	: Mesh{CreateDefaultSubobject<UStaticMeshComponent>(Names::Mesh)},
 	  Movement{CreateDefaultSubobject<UProjectileMovementComponent>(Names::Movement)}
 {
+	bDilatable = true;
 	RootComponent = Mesh;
 	Mesh->SetCollisionProfileName(Names::Projectile);
 	Mesh->SetGenerateOverlapEvents(true);
@@ -40,30 +50,71 @@ void AProjectile::SetSpeed(const float Speed) const
 
 void AProjectile::Explode(const FHitResult& Hit)
 {
-	if (HasAuthority() && CanExplode(Hit))
+	if (!HasAuthority() || !CanExplode(Hit)) return;
+
+	// 리플리케이트되지 않는 발사체는 각 기기가 따로 시뮬레이션하므로 알릴 필요가 없습니다.
+	if (!GetIsReplicated())
+	{
+		OnExplode(Hit);
+	}
+	else if (CVarBatchImpacts.GetValueOnGameThread())
+	{
+		CastChecked<ASaucewichGameState>(GetWorld()->GetGameState())->AddImpact(this, Hit, Team);
+		OnExplode(Hit);
+	}
+	else
 	{
+		SaucewichBench::CountImpactRPCs();
 		MulticastExplode(Hit);
 	}
 }
 
-bool AProjectile::CanExplode(const FHitResult& Hit) const
+void AProjectile::ReceiveImpact(const AActor* const Context, const FProjectileImpact& Impact)
 {
-	return IsTeamValid();
+	FHitResult Hit;
+	Hit.bBlockingHit = true;
+	Hit.Location = Hit.ImpactPoint = Impact.Location;
+	Hit.Normal = Hit.ImpactNormal = Impact.Normal;
+
+	// 폭발한 그 활성화의 발사체라면 액터가 직접 폭발하고 반납됩니다.
+	const auto Projectile = Impact.Projectile;
+	if (IsValid(Projectile) && Projectile->GetActivationSerial() == Impact.Serial)
+	{
+		Projectile->ExplodeFromImpact(Impact, Hit);
+		return;
+	}
+
+	// 풀이 액터를 다시 꺼내 썼거나 아직 이 활성화가 도착하지 않았다면 지금의 발사체는 건드리지 않고 연출만 합니다.
+	// 액터를 받은 적이 없는 클라이언트(관련 없거나 한 번의 갱신 사이에 발사되고 반납된 경우)는 클래스 기본값으로 연출합니다.
+#if !UE_SERVER
+	if (!Cosmetic::IsEnabled(Context)) return;
+	if (IsValid(Projectile)) Projectile->PlayImpactEffects(Projectile, Hit, Impact.Location, Impact.Team);
+	else if (Impact.Class) GetDefault<AProjectile>(Impact.Class)->PlayImpactEffects(Context, Hit, Impact.Location, Impact.Team);
+#endif
 }
 
-void AProjectile::BeginPlay()
+void AProjectile::ExplodeFromImpact(const FProjectileImpact& Impact, const FHitResult& Hit)
 {
-	Super::BeginPlay();
-	
-	const auto GS = CastChecked<ASaucewichGameState>(GetWorld()->GetGameState());
-	GS->AddDilatableActor(this);
+	SetActorLocation(Impact.Location, false, nullptr, ETeleportType::TeleportPhysics);
+
+	// 반납이 먼저 리플리케이트되었을 수도 있으므로 보내온 팀을 쓰고, OnExplode에서 반납한 뒤에는 다시 초기화합니다.
+	Team = Impact.Team;
+	OnExplode(Hit);
+	Team = -1;
+}
+
+bool AProjectile::CanExplode(const FHitResult& Hit) const
+{
+	return IsTeamValid();
 }
 
 void AProjectile::OnActivated()
 {
 	if (HasAuthority())
 	{
-		Team = CastChecked<ATpsCharacter>(GetInstigator())->GetTeam();
+		// 같은 배치의 발사체는 클래스와 Instigator가 같으므로 첫 발사체의 팀을 그대로 씁니다.
+		const auto Leader = static_cast<const AProjectile*>(GetBatchLeader());
+		Team = Leader ? Leader->Team : CastChecked<ATpsCharacter>(GetInstigator())->GetTeam();
 		OnRep_Team();
 	}
 
@@ -85,43 +136,50 @@ void AProjectile::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifet
 void AProjectile::OnExplode(const FHitResult& Hit)
 {
 #if !UE_SERVER
-	const auto World = GetWorld();
-	const auto Location = GetActorLocation();
+	if (Cosmetic::IsEnabled(this)) PlayImpactEffects(this, Hit, GetActorLocation(), Team);
+#endif
+
+	Release();
+}
+
+void AProjectile::PlayImpactEffects(const AActor* const Context, const FHitResult& Hit, const FVector& Location, const uint8 EffectTeam) const
+{
+#if !UE_SERVER
+	const auto World = Context->GetWorld();
 
 	if (ImpactSounds.Num() > 0)
 	{
+		// CDO의 컴포넌트는 등록되지 않아 월드 트랜스폼이 없으므로 상대 스케일을 씁니다.
+		const auto Scale = IsTemplate() ? Mesh->GetRelativeScale3D() : Mesh->GetComponentScale();
 		UGameplayStatics::PlaySoundAtLocation(World,
-			ImpactSounds[FMath::RandHelper(ImpactSounds.Num())].LoadSynchronous(),
-			Location, bVolumeByScale ? Mesh->GetComponentScale().Size() : 1.f,
-			1.f, 0.f, ImpactSoundAttenuation.LoadSynchronous()
+			SyncLoad::Load(ImpactSounds[FMath::RandHelper(ImpactSounds.Num())], Context),
+			Location, bVolumeByScale ? Scale.Size() : 1.f,
+			1.f, 0.f, SyncLoad::Load(ImpactSoundAttenuation, Context)
 		);
 	}
 
-	if (const auto FX = ImpactFX.LoadSynchronous())
+	if (const auto FX = SyncLoad::Load(ImpactFX, Context))
 	{
 		const FTransform Transform{Hit.ImpactNormal.ToOrientationQuat() * FQuat{FRotator{-90.f, 0.f, 0.f}}, Hit.ImpactPoint};
 		const auto PSC = UGameplayStatics::SpawnEmitterAtLocation(
 			World, FX, Transform, true, EPSCPoolMethod::AutoRelease
 		);
-		const auto GS = CastChecked<ASaucewichGameState>(World->GetGameState());
-		GS->AddDilatablePSC(PSC);
-		PSC->SetColorParameter(Names::Color, GetColor());
+		UTimeDilationSubsystem::Get(World)->Register(PSC);
+		PSC->SetColorParameter(Names::Color, GetColor(Context, EffectTeam));
 	}
 
-	if (UUserSettings::Get(this)->bVibration)
+	if (UUserSettings::Get(Context)->bVibration)
 	{
 		UGameplayStatics::SpawnForceFeedbackAtLocation(
-			World, ForceFeedbackEffect.LoadSynchronous(), Location,
+			World, SyncLoad::Load(ForceFeedbackEffect, Context), Location,
 			FRotator::ZeroRotator, false, 1.f, 0.f,
-			ForceFeedbackAttenuation.LoadSynchronous()
+			SyncLoad::Load(ForceFeedbackAttenuation, Context)
 		);
 	}
 
 	if (bSauceMark)
-		ASauceMarker::Add(Team, GetSauceMarkScale(), Hit, this);
+		ASauceMarker::Add(EffectTeam, GetSauceMarkScale(), Hit, Context);
 #endif
-
-	Release();
 }
 
 void AProjectile::OnRep_Team() const
@@ -140,6 +198,17 @@ void AProjectile::MulticastExplode_Implementation(const FHitResult& Hit)
 	if (CanExplode(Hit)) OnExplode(Hit);
 }
 
+void AProjectile::GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const
+{
+#if !UE_SERVER
+	for (auto&& Sound : ImpactSounds) OutPaths.Add(Sound.ToSoftObjectPath());
+	OutPaths.Add(ImpactSoundAttenuation.ToSoftObjectPath());
+	OutPaths.Add(ImpactFX.ToSoftObjectPath());
+	OutPaths.Add(ForceFeedbackEffect.ToSoftObjectPath());
+	OutPaths.Add(ForceFeedbackAttenuation.ToSoftObjectPath());
+#endif
+}
+
 FName AProjectile::GetCollisionProfile() const
 {
 	return Mesh->GetCollisionProfileName();
@@ -147,6 +216,11 @@ FName AProjectile::GetCollisionProfile() const
 
 FLinearColor AProjectile::GetColor() const
 {
-	auto&& Teams = ASaucewichGameMode::GetData(this).Teams;
-	return ensure(Teams.IsValidIndex(Team)) ? Teams[Team].Color : FLinearColor{};
+	return GetColor(this, Team);
+}
+
+FLinearColor AProjectile::GetColor(const UObject* const WorldContextObject, const uint8 InTeam)
+{
+	auto&& Teams = ASaucewichGameMode::GetData(WorldContextObject).Teams;
+	return ensure(Teams.IsValidIndex(InTeam)) ? Teams[InTeam].Color : FLinearColor{};
 }
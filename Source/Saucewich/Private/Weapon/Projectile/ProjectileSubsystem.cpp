@@ -0,0 +1,306 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#include "Weapon/Projectile/ProjectileSubsystem.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+
+#include "Entity/ActorPool.h"
+#include "GameMode/SaucewichBench.h"
+#include "GameMode/SaucewichGameState.h"
+#include "GameMode/TimeDilationSubsystem.h"
+#include "Player/TpsCharacter.h"
+#include "Weapon/Gun.h"
+#include "Weapon/Projectile/GunProjectile.h"
+#include "Saucewich.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Simulation"), STAT_ProjectileSim, STATGROUP_Saucewich);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Simulated Projectiles"), STAT_SimProjectiles, STATGROUP_Saucewich);
+
+static TAutoConsoleVariable<int32> CVarSimulate{
+	TEXT("Saucewich.Projectile.Simulate"), 1,
+	TEXT("1: Gun projectiles are simulated in batch by UProjectileSubsystem\n")
+	TEXT("0: Each projectile actor moves itself with UProjectileMovementComponent")
+};
+
+static TAutoConsoleVariable<int32> CVarParallelSweeps{
+	TEXT("Saucewich.Projectile.ParallelSweeps"), 0,
+	TEXT("Runs projectile sweep queries on worker threads")
+};
+
+static TAutoConsoleVariable<int32> CVarMinParallel{
+	TEXT("Saucewich.Projectile.MinParallel"), 64,
+	TEXT("Minimum number of projectiles to simulate with ParallelFor")
+};
+
+UProjectileSubsystem* UProjectileSubsystem::Get(const UObject* const WorldContextObject)
+{
+	return WorldContextObject->GetWorld()->GetSubsystem<UProjectileSubsystem>();
+}
+
+bool UProjectileSubsystem::IsEnabled()
+{
+	return CVarSimulate.GetValueOnGameThread() != 0;
+}
+
+void UProjectileSubsystem::Fire(AGun* const Gun, const TSubclassOf<AGunProjectile> Class, const TArrayView<const FTransform> Transforms, const FActorSpawnParameters& SpawnParameters, const TArrayView<const float> Ages)
+{
+	check(Class);
+	check(Ages.Num() == 0 || Ages.Num() == Transforms.Num());
+
+	if (!CleanupHandle.IsValid())
+	{
+		if (const auto GS = GetWorld()->GetGameState<ASaucewichGameState>())
+			CleanupHandle = GS->OnCleanup.AddUObject(this, &UProjectileSubsystem::Clear);
+	}
+
+	auto&& Info = GetClassInfo(Class);
+	auto&& Data = Gun->GetGunData();
+	const auto Character = Cast<ATpsCharacter>(Gun->GetInstigator());
+	const auto Team = Character ? Character->GetTeam() : static_cast<uint8>(-1);
+	const auto Gravity = Info.GravityScale * GetWorld()->GetGravityZ();
+	const auto ExpireTime = Info.LifeSpan > 0.f ? SimTime + Info.LifeSpan : MAX_flt;
+	const auto First = Positions.Num();
+
+	for (auto i = 0; i < Transforms.Num(); ++i)
+	{
+		auto&& Transform = Transforms[i];
+		Positions.Add(Transform.GetLocation());
+		Velocities.Add(Transform.GetRotation().GetForwardVector() * Data.ProjectileSpeed);
+		GravityZ.Add(Gravity);
+		Radii.Add(Info.Radius * Transform.GetMaximumAxisScale());
+		FiredTimes.Add(SimTime);
+		ExpireTimes.Add(ExpireTime);
+		FirstSteps.Add(Ages.Num() > 0 ? FMath::Max(Ages[i], 0.f) : -1.f);
+		Profiles.Add(Info.Profile);
+		Teams.Add(Team);
+		Guns.Add(Gun);
+		Visuals.Add(nullptr);
+	}
+
+#if !UE_SERVER
+	if (GetWorld()->GetNetMode() != NM_DedicatedServer)
+	{
+		TArray<APoolActor*, TInlineAllocator<16>> Actors;
+		AActorPool::Get(this)->SpawnBatch(Class, Transforms, SpawnParameters, Actors);
+
+		// 생성에 실패한 액터가 있으면 순서가 어긋나므로, 이 경우에는 보이지 않는 발사체로 남겨 둡니다.
+		if (Actors.Num() == Transforms.Num())
+		{
+			for (auto i = 0; i < Actors.Num(); ++i)
+			{
+				const auto Visual = static_cast<AGunProjectile*>(Actors[i]);
+				Visual->AttachToSimulation(First + i);
+				Visuals[First + i] = Visual;
+			}
+		}
+		else
+		{
+			for (const auto Actor : Actors) Actor->Release();
+		}
+	}
+#endif
+}
+
+void UProjectileSubsystem::Deinitialize()
+{
+	Clear();
+	Super::Deinitialize();
+}
+
+void UProjectileSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileSim);
+
+	DeltaTime *= UTimeDilationSubsystem::Get(this)->GetScale(EDilationGroup::Gameplay);
+	SimTime += DeltaTime;
+
+	const auto Num = Positions.Num();
+	const auto bParallelSweeps = CVarParallelSweeps.GetValueOnGameThread() != 0;
+
+	Ends.SetNumUninitialized(Num, false);
+	Steps.SetNumUninitialized(Num, false);
+	Hits.SetNum(Num, false);
+	bHits.SetNumZeroed(Num, false);
+
+	// 적분과 (원한다면) 충돌 검사는 발사체끼리 서로 영향을 주지 않으므로 나눠서 처리할 수 있습니다.
+	// 이번 프레임 중간에 발사된 발사체는 발사된 뒤 지난 시간만큼만 움직입니다.
+	ParallelFor(Num, [&](const int32 i)
+	{
+		const auto Dt = FirstSteps[i] >= 0.f ? FMath::Min(FirstSteps[i], DeltaTime) : DeltaTime;
+		Steps[i] = Dt;
+		Ends[i] = Positions[i] + Velocities[i] * Dt + FVector{0.f, 0.f, GravityZ[i] * .5f * Dt * Dt};
+		if (bParallelSweeps) bHits[i] = Sweep(i, Hits[i]);
+	}, Num < CVarMinParallel.GetValueOnGameThread());
+
+	const auto KillZ = GetWorld()->GetWorldSettings()->KillZ;
+
+	// 폭발 처리 중에 다른 게임 로직이 실행되므로, 제거는 모두 끝난 뒤 뒤에서부터 합니다.
+	TGuardValue<bool> TickGuard{bTicking, true};
+	Removed.Reset();
+	for (auto i = 0; i < Num; ++i)
+	{
+		if (SimTime >= ExpireTimes[i] || Ends[i].Z < KillZ)
+		{
+			ReleaseVisual(i);
+			Removed.Add(i);
+			continue;
+		}
+
+		if (FirstSteps[i] >= 0.f)
+		{
+			FiredTimes[i] = SimTime - Steps[i];
+			FirstSteps[i] = -1.f;
+		}
+
+		if (!bParallelSweeps) bHits[i] = Sweep(i, Hits[i]);
+
+		if (bHits[i])
+		{
+			Resolve(i, Hits[i]);
+			Removed.Add(i);
+			continue;
+		}
+
+		Positions[i] = Ends[i];
+		Velocities[i].Z += GravityZ[i] * Steps[i];
+
+		if (const auto Visual = Visuals[i])
+		{
+			Visual->GetMesh()->ComponentVelocity = Velocities[i];
+			Visual->SetActorLocationAndRotation(Positions[i], Velocities[i].Rotation(), false, nullptr, ETeleportType::TeleportPhysics);
+		}
+	}
+
+	for (auto i = Removed.Num() - 1; i >= 0; --i)
+		Remove(Removed[i]);
+
+	SET_DWORD_STAT(STAT_SimProjectiles, Positions.Num());
+}
+
+bool UProjectileSubsystem::IsTickable() const
+{
+	return Positions.Num() > 0 && !HasAnyFlags(RF_ClassDefaultObject);
+}
+
+TStatId UProjectileSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileSubsystem, STATGROUP_Tickables);
+}
+
+const UProjectileSubsystem::FClassInfo& UProjectileSubsystem::GetClassInfo(UClass* const Class)
+{
+	if (const auto Found = ClassInfos.Find(Class))
+		return *Found;
+
+	const auto Def = GetDefault<AGunProjectile>(Class);
+	const auto Mesh = Def->GetMesh();
+	const auto StaticMesh = Mesh->GetStaticMesh();
+
+	FClassInfo Info;
+	Info.Profile = Def->GetCollisionProfile();
+	Info.Radius = StaticMesh ? StaticMesh->GetBounds().BoxExtent.GetMin() * Mesh->GetRelativeScale3D().GetMax() : 1.f;
+	Info.GravityScale = Def->GetMovement()->ProjectileGravityScale;
+	Info.LifeSpan = Def->InitialLifeSpan;
+	return ClassInfos.Add(Class, Info);
+}
+
+bool UProjectileSubsystem::Sweep(const int32 Index, FHitResult& OutHit) const
+{
+	const auto Gun = Guns[Index];
+
+	FCollisionQueryParams Params{SCENE_QUERY_STAT(ProjectileSweep), false, Gun};
+	if (Gun && Gun->GetInstigator()) Params.AddIgnoredActor(Gun->GetInstigator());
+
+	SaucewichBench::CountTraces();
+	return GetWorld()->SweepSingleByProfile(
+		OutHit, Positions[Index], Ends[Index], FQuat::Identity, Profiles[Index],
+		FCollisionShape::MakeSphere(Radii[Index]), Params
+	);
+}
+
+void UProjectileSubsystem::Resolve(const int32 Index, const FHitResult& Hit)
+{
+	if (const auto Visual = Visuals[Index])
+	{
+		DetachVisual(Index);
+		Visual->GetMesh()->ComponentVelocity = Velocities[Index];
+		Visual->SetActorLocation(Hit.Location, false, nullptr, ETeleportType::TeleportPhysics);
+
+		// 데미지와 소스 자국은 기존처럼 액터의 OnExplode에서 처리됩니다.
+		Visual->Explode(Hit);
+		if (Visual->IsActive()) Visual->Release();
+	}
+	else if (Teams[Index] != static_cast<uint8>(-1) && IsValid(Guns[Index]))
+	{
+		AGunProjectile::HandleImpact(*Guns[Index], SimTime - FiredTimes[Index], Hit, Velocities[Index].GetSafeNormal());
+	}
+}
+
+void UProjectileSubsystem::ReleaseVisual(const int32 Index)
+{
+	if (const auto Visual = Visuals[Index])
+	{
+		DetachVisual(Index);
+		Visual->Release();
+	}
+}
+
+void UProjectileSubsystem::DetachVisual(const int32 Index)
+{
+	if (const auto Visual = Visuals[Index])
+	{
+		Visual->SimIndex = INDEX_NONE;
+		Visuals[Index] = nullptr;
+	}
+
+	// 액터가 다른 이유로 반납되었다면 발사체도 함께 사라집니다. 실제 제거는 다음 Tick에서 합니다.
+	ExpireTimes[Index] = -MAX_flt;
+}
+
+void UProjectileSubsystem::Remove(const int32 Index)
+{
+	Positions.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	GravityZ.RemoveAtSwap(Index, 1, false);
+	Radii.RemoveAtSwap(Index, 1, false);
+	FiredTimes.RemoveAtSwap(Index, 1, false);
+	ExpireTimes.RemoveAtSwap(Index, 1, false);
+	FirstSteps.RemoveAtSwap(Index, 1, false);
+	Profiles.RemoveAtSwap(Index, 1, false);
+	Teams.RemoveAtSwap(Index, 1, false);
+	Guns.RemoveAtSwap(Index, 1, false);
+	Visuals.RemoveAtSwap(Index, 1, false);
+
+	if (Visuals.IsValidIndex(Index) && Visuals[Index])
+		Visuals[Index]->SimIndex = Index;
+}
+
+void UProjectileSubsystem::Clear()
+{
+	for (auto i = 0; i < Visuals.Num(); ++i)
+		ReleaseVisual(i);
+
+	if (bTicking)
+	{
+		for (auto& ExpireTime : ExpireTimes) ExpireTime = -MAX_flt;
+		return;
+	}
+
+	Positions.Reset();
+	Velocities.Reset();
+	GravityZ.Reset();
+	Radii.Reset();
+	FiredTimes.Reset();
+	ExpireTimes.Reset();
+	FirstSteps.Reset();
+	Profiles.Reset();
+	Teams.Reset();
+	Guns.Reset();
+	Visuals.Reset();
+}
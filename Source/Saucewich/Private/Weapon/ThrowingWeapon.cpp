@@ -7,6 +7,7 @@
 
 #include "Entity/ActorPool.h"
 #include "Weapon/Projectile/Projectile.h"
+#include "Saucewich.h"
 
 const FThrowingWeaponData& AThrowingWeapon::GetThrowingWeaponData() const
 {
@@ -24,7 +25,7 @@ void AThrowingWeapon::SlotP()
 	if (TimerManager.TimerExists(ReloadTimer)) return;
 
 	auto&& Data = GetThrowingWeaponData();
-	const auto ProjCls = Data.ProjectileClass.LoadSynchronous();
+	const auto ProjCls = SyncLoad::Load(Data.ProjectileClass, this);
 	check(ProjCls);
 
 	if (HasAuthority() || !GetDefault<AActor>(ProjCls)->GetIsReplicated())
@@ -44,6 +45,11 @@ void AThrowingWeapon::SlotP()
 	OnAvailabilityChanged(false);
 }
 
+void AThrowingWeapon::GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const
+{
+	OutPaths.Add(GetThrowingWeaponData().ProjectileClass.ToSoftObjectPath());
+}
+
 void AThrowingWeapon::OnReleased()
 {
 	Super::OnReleased();
@@ -3,6 +3,7 @@
 #include "Weapon/Weapon.h"
 
 #include "Components/StaticMeshComponent.h"
+#include "Engine/AssetManager.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "TimerManager.h"
 #include "Net/UnrealNetwork.h"
@@ -16,6 +17,8 @@ const FWeaponData& AWeapon::GetWeaponDataFromClass(const TSubclassOf<AWeapon> Cl
 	return GetDefault<AWeapon>(Class)->GetData();
 }
 
+FOnWeaponOwnerChanged AWeapon::OnOwnerChanged;
+
 AWeapon::AWeapon()
 	:SceneRoot{CreateDefaultSubobject<USceneComponent>(NAME("SceneRoot"))},
 	Mesh{ CreateDefaultSubobject<UStaticMeshComponent>(Names::Mesh) }
@@ -56,6 +59,13 @@ void AWeapon::OnRep_Equipped()
 	else Holster();
 }
 
+void AWeapon::SetOwner(AActor* const NewOwner)
+{
+	const auto OldOwner = GetOwner();
+	Super::SetOwner(NewOwner);
+	if (OldOwner != NewOwner) OnOwnerChanged.Broadcast(this, OldOwner, NewOwner);
+}
+
 int32 AWeapon::GetColIdx() const
 {
 	return Mesh->GetMaterialIndex(Names::TeamColor);
@@ -80,6 +90,7 @@ void AWeapon::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeP
 
 void AWeapon::OnActivated()
 {
+	LoadAssets();
 	Init();
 	OnAvailabilityChanged(true);
 }
@@ -89,6 +100,20 @@ void AWeapon::OnReleased()
 	Holster();
 }
 
+void AWeapon::LoadAssets()
+{
+	if (AssetsHandle.IsValid()) return;
+
+	TArray<FSoftObjectPath> Paths;
+	GetAssetsToLoad(Paths);
+	Paths.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull(); });
+	if (Paths.Num() == 0) return;
+
+	AssetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		MoveTemp(Paths), FStreamableDelegate::CreateUObject(this, &AWeapon::OnAssetsLoaded)
+	);
+}
+
 void AWeapon::OnAvailabilityChanged(const bool bAvailable) const
 {
 	if (const auto Ply = GetOwner())
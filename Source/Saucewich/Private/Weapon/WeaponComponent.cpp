@@ -4,14 +4,73 @@
 
 #include "Components/InputComponent.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 #include "Entity/ActorPool.h"
+#include "GameMode/SaucewichBench.h"
 #include "Player/TpsCharacter.h"
 #include "Weapon/Gun.h"
 #include "UserSettings.h"
 #include "Names.h"
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("AutoFire Traces"), STAT_AutoFireTraces, STATGROUP_Saucewich);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AutoFire Early Traces"), STAT_AutoFireEarlyTraces, STATGROUP_Saucewich);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("AutoFire Decision Latency (ms)"), STAT_AutoFireLatency, STATGROUP_Saucewich);
+
+static TAutoConsoleVariable<float> CVarAutoFireRate{
+	TEXT("Saucewich.AutoFire.Rate"), 20.f,
+	TEXT("Number of auto fire line of sight checks per second while an enemy is inside the aim box. 0 checks every frame.\n")
+	TEXT("A check also runs immediately when the closest enemy inside the aim box changes.")
+};
+
+static TAutoConsoleVariable<float> CVarAutoFireReleaseDelay{
+	TEXT("Saucewich.AutoFire.ReleaseDelay"), .15f,
+	TEXT("Auto fire keeps the trigger held for this many seconds after the last successful check")
+};
+
+static TAutoConsoleVariable<int32> CVarInputStream{
+	TEXT("Saucewich.Net.InputStream"), 1,
+	TEXT("1: Weapon input is sent as a bit-packed state over an unreliable RPC and replicated to other clients\n")
+	TEXT("0: Each press and release is sent as a reliable server RPC and multicast (legacy). Must match between server and clients.")
+};
+
+static TAutoConsoleVariable<float> CVarInputRate{
+	TEXT("Saucewich.Net.InputRate"), 30.f,
+	TEXT("Maximum number of weapon input states a client sends per second")
+};
+
+static TAutoConsoleVariable<int32> CVarInputRedundancy{
+	TEXT("Saucewich.Net.InputRedundancy"), 3,
+	TEXT("Number of times an idle weapon input state is resent after it changes, to survive packet loss")
+};
+
+static TAutoConsoleVariable<float> CVarInputResendRate{
+	TEXT("Saucewich.Net.InputResendRate"), 5.f,
+	TEXT("Times per second an idle weapon input state keeps being resent after redundancy runs out, until the server acknowledges it")
+};
+
+bool FWeaponInputState::NetSerialize(FArchive& Ar, UPackageMap*, bool& bOutSuccess)
+{
+	Ar << Sequence;
+
+	uint8 bFireBit = bFire;
+	Ar.SerializeBits(&bFireBit, 1);
+	bFire = bFireBit != 0;
+	if (bFire) Ar << FireSeed;
+	else FireSeed = 0;
+
+	// 대부분은 슬롯 키를 누르지 않으므로 1비트로 끝냅니다.
+	uint8 bAnySlot = Slots != 0;
+	Ar.SerializeBits(&bAnySlot, 1);
+	if (bAnySlot) Ar.SerializeBits(&Slots, MaxSlotBits);
+	else Slots = 0;
+
+	bOutSuccess = true;
+	return true;
+}
+
 UWeaponComponent::UWeaponComponent()
 {
 	SetIsReplicatedByDefault(true);
@@ -19,6 +78,11 @@ UWeaponComponent::UWeaponComponent()
 	PrimaryComponentTick.bCanEverTick = true;
 }
 
+bool UWeaponComponent::IsInputStreamEnabled()
+{
+	return CVarInputStream.GetValueOnGameThread() != 0;
+}
+
 void UWeaponComponent::AddOnEquipWeapon(const FOnEquipWeaponSingle& Delegate)
 {
 	check(Delegate.IsBound());
@@ -52,12 +116,11 @@ void UWeaponComponent::TickComponent(const float DeltaTime, const ELevelTick Tic
 	{
 		if (UUserSettings::Get(this)->bAutoFire)
 		{
-			FHitResult Hit;
-			bShouldAutoFire = GunTrace(Hit);
+			bShouldAutoFire = SenseAutoFire(DeltaTime);
 		}
 		else
 		{
-			bShouldAutoFire = false;
+			ResetAutoFire();
 		}
 
 		const auto bShouldFire = bShouldAutoFire || bFirePressed;
@@ -69,6 +132,8 @@ void UWeaponComponent::TickComponent(const float DeltaTime, const ELevelTick Tic
 		{
 			if (bShouldFire) StartFire();
 		}
+
+		if (IsInputStreamEnabled()) PublishInput(DeltaTime);
 	}
 }
 
@@ -78,6 +143,14 @@ void UWeaponComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out
 
 	DOREPLIFETIME(UWeaponComponent, Weapons);
 	DOREPLIFETIME(UWeaponComponent, Active);
+
+	FDoRepLifetimeParams Params;
+	Params.bIsPushBased = true;
+	Params.Condition = COND_SkipOwner;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UWeaponComponent, Input, Params);
+
+	Params.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST(UWeaponComponent, AckedSequence, Params);
 }
 
 void UWeaponComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
@@ -109,6 +182,69 @@ bool UWeaponComponent::GunTrace(FHitResult& OutHit) const
 	return false;
 }
 
+bool UWeaponComponent::SenseAutoFire(const float DeltaTime)
+{
+	const auto Gun = Cast<AGun>(GetActiveWeapon());
+	if (!Gun)
+	{
+		ResetAutoFire();
+		return false;
+	}
+
+	AutoFireSenseTime += DeltaTime;
+	AutoFireHoldTime += DeltaTime;
+	const auto Now = GetWorld()->GetTimeSeconds();
+
+	// 후보는 프레임마다 한 번 만들어지는 캡슐 스냅샷에서 찾으므로 물리 쿼리가 들지 않습니다.
+	const auto Candidate = Gun->FindAutoAimCandidate();
+	const auto bChanged = Candidate != AutoFireCandidate;
+	if (bChanged)
+	{
+		AutoFireCandidate = Candidate;
+		AutoFireChangeTime = Now;
+	}
+
+	// 후보가 없으면 GunTrace도 빗나가므로 트레이스하지 않습니다.
+	if (!Candidate)
+	{
+		bAutoFireHit = false;
+	}
+	else
+	{
+		const auto Rate = CVarAutoFireRate.GetValueOnGameThread();
+		if (bChanged || Rate <= 0.f || AutoFireSenseTime >= 1.f / Rate)
+		{
+			AutoFireSenseTime = 0.f;
+			INC_DWORD_STAT(STAT_AutoFireTraces);
+			if (bChanged) INC_DWORD_STAT(STAT_AutoFireEarlyTraces);
+
+			FHitResult Hit;
+			bAutoFireHit = Gun->GunTrace(Hit);
+		}
+	}
+
+	if (bAutoFireHit) AutoFireHoldTime = 0.f;
+
+	// 적이 잠깐 가려지거나 상자 가장자리를 오가도 발사가 끊기지 않도록 떼는 것은 늦춥니다.
+	const auto bShouldFire = AutoFireHoldTime < CVarAutoFireReleaseDelay.GetValueOnGameThread();
+	if (bShouldFire != !!bShouldAutoFire && AutoFireChangeTime >= 0.f)
+	{
+		SET_FLOAT_STAT(STAT_AutoFireLatency, (Now - AutoFireChangeTime) * 1000.f);
+		AutoFireChangeTime = -1.f;
+	}
+
+	return bShouldFire;
+}
+
+void UWeaponComponent::ResetAutoFire()
+{
+	bShouldAutoFire = false;
+	bAutoFireHit = false;
+	AutoFireCandidate = nullptr;
+	AutoFireHoldTime = MAX_flt;
+	AutoFireChangeTime = -1.f;
+}
+
 bool UWeaponComponent::TrySelectWeapon(const uint8 Slot)
 {
 	if (Slot >= WeaponSlots) return false;
@@ -215,7 +351,7 @@ void UWeaponComponent::FireP()
 	bFirePressed = true;
 }
 
-void UWeaponComponent::ServerFireP_Implementation() { MulticastFireP(); }
+void UWeaponComponent::ServerFireP_Implementation() { SaucewichBench::CountInputMessages(2); MulticastFireP(); }
 bool UWeaponComponent::ServerFireP_Validate() { return true; }
 void UWeaponComponent::MulticastFireP_Implementation()
 {
@@ -234,8 +370,13 @@ void UWeaponComponent::StartFire()
 	if (!Owner->IsAlive()) return;
 	if (auto W = GetActiveWeapon())
 	{
+		const auto bLocal = Owner->IsLocallyControlled();
+		const auto bStream = IsInputStreamEnabled();
+
+		// 시드는 무기가 발사를 시작하기 전에 정해져 있어야 합니다.
+		if (bLocal && bStream) FireSeed = FMath::Rand() & 0xFFFF;
 		W->FireP();
-		if (Owner->IsLocallyControlled()) ServerFireP();
+		if (bLocal && !bStream) ServerFireP();
 	}
 	bFiring = true;
 }
@@ -247,12 +388,12 @@ void UWeaponComponent::StopFire()
 	if (auto W = GetActiveWeapon())
 	{
 		W->FireR();
-		if (Owner->IsLocallyControlled()) ServerFireR();
+		if (Owner->IsLocallyControlled() && !IsInputStreamEnabled()) ServerFireR();
 	}
 	bFiring = false;
 }
 
-void UWeaponComponent::ServerFireR_Implementation() { MulticastFireR(); }
+void UWeaponComponent::ServerFireR_Implementation() { SaucewichBench::CountInputMessages(2); MulticastFireR(); }
 bool UWeaponComponent::ServerFireR_Validate() { return true; }
 void UWeaponComponent::MulticastFireR_Implementation()
 {
@@ -267,11 +408,22 @@ void UWeaponComponent::SlotP(const uint8 Slot)
 	if (auto W = Weapons[Slot])
 	{
 		W->SlotP();
-		if (Owner->IsLocallyControlled()) ServerSlotP(Slot);
+		if (Owner->IsLocallyControlled())
+		{
+			if (IsInputStreamEnabled())
+			{
+				HeldSlots |= 1 << Slot;
+				LatchedSlots |= 1 << Slot;
+			}
+			else
+			{
+				ServerSlotP(Slot);
+			}
+		}
 	}
 }
 
-void UWeaponComponent::ServerSlotP_Implementation(const uint8 Slot) { MulticastSlotP(Slot); }
+void UWeaponComponent::ServerSlotP_Implementation(const uint8 Slot) { SaucewichBench::CountInputMessages(2); MulticastSlotP(Slot); }
 bool UWeaponComponent::ServerSlotP_Validate(const uint8 Slot) { return Slot < Weapons.Num(); }
 void UWeaponComponent::MulticastSlotP_Implementation(const uint8 Slot)
 {
@@ -282,18 +434,113 @@ void UWeaponComponent::MulticastSlotP_Implementation(const uint8 Slot)
 void UWeaponComponent::SlotR(const uint8 Slot)
 {
 	const auto Owner = CastChecked<ATpsCharacter>(GetOwner());
+
+	// 누르는 동안 죽거나 무기가 바뀌어도 키를 뗀 것은 보내야 합니다.
+	const auto bStream = Owner->IsLocallyControlled() && IsInputStreamEnabled();
+	if (bStream) HeldSlots &= ~(1 << Slot);
+
 	if (!Owner->IsAlive()) return;
 	if (auto W = Weapons[Slot])
 	{
 		W->SlotR();
-		if (Owner->IsLocallyControlled()) ServerSlotR(Slot);
+		if (Owner->IsLocallyControlled() && !bStream) ServerSlotR(Slot);
 	}
 }
 
-void UWeaponComponent::ServerSlotR_Implementation(const uint8 Slot) { MulticastSlotR(Slot); }
+void UWeaponComponent::ServerSlotR_Implementation(const uint8 Slot) { SaucewichBench::CountInputMessages(2); MulticastSlotR(Slot); }
 bool UWeaponComponent::ServerSlotR_Validate(const uint8 Slot) { return Slot < Weapons.Num(); }
 void UWeaponComponent::MulticastSlotR_Implementation(const uint8 Slot)
 {
 	const auto Owner = CastChecked<ATpsCharacter>(GetOwner());
 	if (!Owner->IsLocallyControlled()) SlotR(Slot);
 }
+
+void UWeaponComponent::PublishInput(const float DeltaTime)
+{
+	InputSendTime += DeltaTime;
+
+	// 클라이언트는 정해진 간격마다 한 번만 보냅니다. 그 사이에 눌렀다 뗀 슬롯 키는 LatchedSlots에 남아 있습니다.
+	const auto bAuthority = GetOwner()->HasAuthority();
+	if (!bAuthority && InputSendTime < 1.f / FMath::Max(CVarInputRate.GetValueOnGameThread(), 1.f)) return;
+
+	FWeaponInputState State;
+	State.bFire = bFiring;
+	State.FireSeed = bFiring ? FireSeed : 0;
+	State.Slots = HeldSlots | LatchedSlots;
+	LatchedSlots = 0;
+
+	if (!State.IsSameInput(Input))
+	{
+		State.Sequence = Input.Sequence + 1;
+		Input = State;
+		RedundantSends = CVarInputRedundancy.GetValueOnGameThread();
+
+		if (bAuthority)
+		{
+			SaucewichBench::CountInputMessages();
+			MARK_PROPERTY_DIRTY_FROM_NAME(UWeaponComponent, Input, this);
+		}
+	}
+
+	if (bAuthority) return;
+
+	// 키를 누르고 있는 동안에는 계속 보내므로, 패킷을 잃어도 다음 패킷으로 맞춰집니다.
+	if (!Input.IsIdle()) RedundantSends = FMath::Max<uint8>(RedundantSends, 1);
+	if (RedundantSends > 0)
+	{
+		--RedundantSends;
+	}
+	else
+	{
+		// 떼는 입력이 모두 유실되면 다음 입력까지 계속 쏘게 되므로, 서버가 받았다고 알려 올 때까지 느린 간격으로 보냅니다.
+		if (Input.Sequence == AckedSequence) return;
+		if (InputSendTime < 1.f / FMath::Max(CVarInputResendRate.GetValueOnGameThread(), 1.f)) return;
+	}
+
+	InputSendTime = 0.f;
+	ServerSetInput(Input);
+}
+
+void UWeaponComponent::ServerSetInput_Implementation(const FWeaponInputState& NewInput)
+{
+	SaucewichBench::CountInputMessages();
+
+	// 순서가 뒤바뀌었거나 중복된 패킷은 버립니다. Sequence는 한 바퀴 돌 수 있으므로 차이의 부호로 비교합니다.
+	if (static_cast<int8>(NewInput.Sequence - Input.Sequence) <= 0) return;
+
+	const auto OldInput = Input;
+	Input = NewInput;
+	AckedSequence = NewInput.Sequence;
+	MARK_PROPERTY_DIRTY_FROM_NAME(UWeaponComponent, Input, this);
+	MARK_PROPERTY_DIRTY_FROM_NAME(UWeaponComponent, AckedSequence, this);
+	ApplyInput(OldInput);
+}
+
+bool UWeaponComponent::ServerSetInput_Validate(const FWeaponInputState& NewInput)
+{
+	return NewInput.Slots < 1 << Weapons.Num();
+}
+
+void UWeaponComponent::OnRep_Input(const FWeaponInputState& OldInput)
+{
+	ApplyInput(OldInput);
+}
+
+void UWeaponComponent::ApplyInput(const FWeaponInputState& OldInput)
+{
+	for (uint8 Slot = 0; Slot < Weapons.Num(); ++Slot)
+	{
+		const auto bPressed = (Input.Slots >> Slot & 1) != 0;
+		if (bPressed == ((OldInput.Slots >> Slot & 1) != 0)) continue;
+		if (bPressed) SlotP(Slot);
+		else SlotR(Slot);
+	}
+
+	// 시드가 바뀌었다면 보내는 간격 사이에 발사를 멈췄다가 다시 시작한 것입니다.
+	if (Input.bFire != OldInput.bFire || Input.FireSeed != OldInput.FireSeed)
+	{
+		if (OldInput.bFire) StopFire();
+		FireSeed = Input.FireSeed;
+		if (Input.bFire) StartFire();
+	}
+}
@@ -8,17 +8,49 @@
 class APoolActor;
 class USaucewichInstance;
 
+USTRUCT(BlueprintType)
+struct SAUCEWICH_API FActorPoolBudget
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	TSoftClassPtr<APoolActor> Class;
+
+	// 맵 로드 시 미리 생성해 둘 액터 수
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(UIMin=0, ClampMin=0))
+	int32 Prewarm;
+
+	// 풀에 보관할 최대 액터 수. 초과분은 반납될 때 파괴됩니다. 0이면 제한 없음
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, meta=(UIMin=0, ClampMin=0))
+	int32 HighWaterMark;
+};
+
+struct FActorPoolStats
+{
+	// 풀에서 꺼내 재사용한 횟수
+	uint32 Hits = 0;
+
+	// 풀이 비어 있어서 새로 스폰한 횟수
+	uint32 Misses = 0;
+
+	// HighWaterMark를 넘어서 파괴된 횟수
+	uint32 Evictions = 0;
+
+	// 풀에 보관되었던 최대 액터 수
+	int32 Peak = 0;
+};
+
 UCLASS(NotBlueprintable, NotPlaceable)
 class SAUCEWICH_API AActorPool final : public AActor
 {
 	GENERATED_BODY()
-	
+
 public:
 	UFUNCTION(BlueprintPure, meta=(DisplayName="Get Actor Pool", WorldContext=WorldContextObject))
 	static AActorPool* Get(const UObject* WorldContextObject);
 	static AActorPool* Get(const UWorld* World);
 	static AActorPool* Get(const USaucewichInstance* SaucewichInstance);
-	
+
 	APoolActor* Spawn(TSubclassOf<APoolActor> Class, const FTransform& Transform = FTransform::Identity, const struct FActorSpawnParameters& SpawnParameters = DefaultParameters);
 
 	template <class T>
@@ -35,9 +67,73 @@ public:
 		return CastChecked<T>(Spawn(T::StaticClass(), Transform, SpawnParameters), ECastCheckedType::NullAllowed);
 	}
 
+	/**
+	 * 같은 클래스의 액터를 Transforms 개수만큼 한 번에 꺼냅니다.
+	 * 풀 조회는 한 번만 하며, 첫 번째 액터 이후의 액터들은 활성화될 때 첫 번째 액터의 데이터를 공유할 수 있습니다.
+	 * 생성에 실패한 액터는 OutActors에 추가되지 않습니다.
+	 */
+	template <class Allocator>
+	void SpawnBatch(const TSubclassOf<APoolActor> Class, const TArrayView<const FTransform> Transforms, const FActorSpawnParameters& SpawnParameters, TArray<APoolActor*, Allocator>& OutActors)
+	{
+		const auto Start = OutActors.AddUninitialized(Transforms.Num());
+		const auto Num = SpawnBatchInternal(Class, Transforms, SpawnParameters, OutActors.GetData() + Start);
+		OutActors.SetNum(Start + Num, false);
+	}
+
 	void Release(APoolActor* Actor);
 
+	/**
+	 * 풀에 보관된 액터가 Num개가 되도록 미리 스폰해 둡니다.
+	 * 클라이언트에서는 리플리케이트되지 않는 클래스만 생성합니다.
+	 */
+	void Prewarm(TSubclassOf<APoolActor> Class, int32 Num);
+
+	// 풀에 보관할 최대 액터 수를 지정합니다. 0이면 제한 없음
+	void SetHighWaterMark(TSubclassOf<APoolActor> Class, int32 HighWaterMark);
+
+	void ApplyBudget(const FActorPoolBudget& Budget);
+
+	const FActorPoolStats* GetStats(TSubclassOf<APoolActor> Class) const;
+	void DumpStats(FOutputDevice& Ar) const;
+
+	// 모든 클래스에 대해 풀에서 대기 중인 액터 수
+	int32 GetNumPooled() const;
+
+#if !UE_BUILD_SHIPPING
+	// 기존 TMap + TWeakObjectPtr 스택 방식과 intrusive free-list 방식의 획득/반납 비용을 비교합니다.
+	static void Benchmark(UWorld* World, int32 Iterations, FOutputDevice& Ar);
+#endif
+
+protected:
+	void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+
 private:
+	friend APoolActor;
+
+	struct FClassPool
+	{
+		// 가장 최근에 반납된 액터. 나머지는 APoolActor::NextFree로 이어집니다.
+		APoolActor* Head = nullptr;
+		int32 NumFree = 0;
+		int32 HighWaterMark = 0;
+		FActorPoolStats Stats;
+		TWeakObjectPtr<UClass> Class;
+	};
+
+	int32 SpawnBatchInternal(TSubclassOf<APoolActor> Class, TArrayView<const FTransform> Transforms, const FActorSpawnParameters& SpawnParameters, APoolActor** OutActors);
+
+	int32 ResolvePoolIndex(UClass* Class);
+	FClassPool& GetClassPool(APoolActor* Actor);
+
+	void Push(FClassPool& ClassPool, APoolActor* Actor);
+	APoolActor* Pop(FClassPool& ClassPool);
+	void Unlink(FClassPool& ClassPool, APoolActor* Actor);
+	void Unlink(APoolActor* Actor);
+
 	static const FActorSpawnParameters DefaultParameters;
-	TMap<TSubclassOf<APoolActor>, TArray<TWeakObjectPtr<APoolActor>>> Pool;
+
+	// 모든 풀이 공유하는 클래스 인덱스 카운터
+	static int32 NumClassIndices;
+
+	TArray<FClassPool> Pools;
 };
@@ -19,7 +19,7 @@ public:
 	uint8 bSpawnedFromSpawner : 1;
 
 protected:
-	void BeginPlay() override;
+	void PostInitializeComponents() override;
 	void Tick(float DeltaSeconds) override;
 
 	void NotifyActorBeginOverlap(AActor* OtherActor) override;
@@ -57,6 +57,7 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta=(AllowPrivateAccess=true))
 	UStaticMeshComponent* Mesh;
 
+	// 데디케이티드 서버에서는 null입니다.
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta=(AllowPrivateAccess=true))
 	class UShadowComponent* Shadow;
 
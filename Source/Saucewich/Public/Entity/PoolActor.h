@@ -3,6 +3,7 @@
 #pragma once
 
 #include "GameFramework/Actor.h"
+#include "GameMode/TimeDilationSubsystem.h"
 #include "PoolActor.generated.h"
 
 UENUM()
@@ -21,14 +22,28 @@ public:
 	void Release(bool bForce = false);
 	void Activate(bool bForce = false);
 	bool IsActive() const { return Activation == EActivation::Activated; }
+
+	// 활성화될 때마다 늘어나는 6비트 횟수. 클라이언트에서는 마지막으로 리플리케이트된 값입니다.
+	uint8 GetActivationSerial() const { return RepActivation >> 2; }
 	void LifeSpanExpired() override { Release(); }
 
+	// 서버에서 리플리케이트되는 풀 액터 중 휴면 중인 것과 깨어 있는 것의 수
+	static int32 GetNumDormant() { return NumDormant; }
+	static int32 GetNumAwake() { return NumAwake; }
+
 protected:
 	void BeginPlay() override;
+	void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 	
 	virtual void OnReleased() {}
 	virtual void OnActivated() {}
 
+	// AActorPool::SpawnBatch로 함께 활성화되는 중이라면 같은 배치의 첫 번째 액터를 반환합니다. OnActivated 안에서만 유효합니다.
+	const APoolActor* GetBatchLeader() const { return BatchLeader; }
+
+	// 켜져 있으면 활성화되어 있는 동안 Gameplay 시간 배율을 따릅니다. 생성자에서 정합니다.
+	uint8 bDilatable : 1;
+
 	UFUNCTION(BlueprintImplementableEvent, meta=(DisplayName="OnReleased"))
 	void BP_OnReleased();
 
@@ -38,9 +53,40 @@ protected:
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 private:
+	friend class AActorPool;
+
 	UFUNCTION()
 	void OnRep_Activation();
 
-	UPROPERTY(ReplicatedUsing=OnRep_Activation, Transient)
+	void SetActivation(EActivation NewActivation);
+
+	// 풀에 들어가 있는 동안에는 리플리케이션을 멈춥니다. 서버에서만 의미가 있습니다.
+	void SetDormant(bool bDormant);
+
+	static int32 NumDormant;
+	static int32 NumAwake;
+
+	// 풀에 보관되어 있는 동안 같은 클래스의 다른 액터들과 이어지는 intrusive free-list 링크입니다.
+	APoolActor* PrevFree = nullptr;
+	APoolActor* NextFree = nullptr;
+
+	const APoolActor* BatchLeader = nullptr;
+
+	FDilationHandle DilationHandle;
+
+	// 이 액터를 보관하고 있는 풀. 풀에 들어 있지 않으면 null입니다.
+	AActorPool* OwningPool = nullptr;
+
+	// 클래스별 풀의 인덱스. CDO의 값이 클래스의 인덱스이며, 인스턴스는 처음 풀에 들어갈 때 이를 복사합니다.
+	mutable int32 PoolIndex = INDEX_NONE;
+
 	EActivation Activation;
+
+	// 하위 2비트는 Activation, 나머지는 활성화 횟수입니다.
+	// 휴면 중에 반납과 재활성화가 겹쳐 상태가 같아 보여도 클라이언트가 다시 활성화하도록 횟수를 함께 보냅니다.
+	UPROPERTY(ReplicatedUsing=OnRep_Activation, Transient)
+	uint8 RepActivation;
+
+	// 휴면 수에 포함되는 액터인지 여부
+	uint8 bCountDormancy : 1;
 };
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "GameFramework/Actor.h"
+#include "WorldCollision.h"
 #include "SauceMarker.generated.h"
 
 class UInstancedStaticMeshComponent;
@@ -18,12 +19,29 @@ struct FSauceMarkers
 	UInstancedStaticMeshComponent* PickRand() const;
 };
 
+// 검사를 기다리는 소스 자국
+struct FSauceMarkRequest
+{
+	FTransform Transform;
+	FVector ImpactPoint;
+	FVector ImpactNormal;
+	TWeakObjectPtr<const AActor> Ignore;
+
+	// 비동기 검사 핸들. 네 방향 라인 트레이스와 바닥 높이를 찾는 스윕입니다.
+	FTraceHandle Traces[5];
+
+	uint8 Team;
+};
+
 UCLASS(NotPlaceable)
 class SAUCEWICH_API ASauceMarker : public AActor
 {
 	GENERATED_BODY()
 	
 public:
+	ASauceMarker();
+
+	// 자국은 바로 찍히지 않고 큐에 쌓였다가 Tick에서 한꺼번에 검사하고 추가됩니다.
 	static void Add(uint8 Team, float Scale, const FHitResult& Hit, const AActor* Ignore);
 	static void Add(const AActor* Owner, uint8 Team, const FVector& Location, float Scale = 1.f);
 
@@ -32,16 +50,56 @@ public:
 
 protected:
 	void BeginPlay() override;
+	void Tick(float DeltaSeconds) override;
 
 	UFUNCTION(BlueprintImplementableEvent)
 	UInstancedStaticMeshComponent* CreateComp();
 
 private:
 	void Cleanup();
+
+	bool Validate(const FSauceMarkRequest& Request, float& OutOffset) const;
+	void RequestAsyncTraces(FSauceMarkRequest& Request) const;
+	bool QueryAsyncTraces(const FSauceMarkRequest& Request, bool& bOutValid, float& OutOffset) const;
+	void Accept(const FSauceMarkRequest& Request, float Offset);
+	void Commit();
+	void UpdateInstanceStat() const;
+
+	static FIntVector GetCell(const FVector& Location);
+	void AddToGrid(UInstancedStaticMeshComponent* Comp, int32 Index, const FVector& Location);
+	void RemoveFromGrid(UInstancedStaticMeshComponent* Comp, int32 Index);
+
+	// 맨 뒤의 인스턴스를 빈자리로 옮기고 맨 뒤를 지우므로 나머지 인스턴스가 밀리지 않습니다.
+	void RemoveInstances(UInstancedStaticMeshComponent* Comp, TArray<int32>& Indices);
 	
 	UPROPERTY(EditDefaultsOnly)
 	TArray<TSoftObjectPtr<UMaterialInterface>> Materials;
 
 	UPROPERTY(Transient)
 	TArray<FSauceMarkers> TeamMarkers;
+
+	TArray<FSauceMarkRequest> Pending;
+
+	// 지난 프레임에 비동기 검사를 요청한 자국들
+	TArray<FSauceMarkRequest> Tracing;
+
+	// 이번 프레임에 컴포넌트마다 추가할 인스턴스 (컴포넌트 공간)
+	TMap<UInstancedStaticMeshComponent*, TArray<FTransform>> Batches;
+
+	// 용량이 찼을 때 다음에 덮어쓸 (가장 오래된) 인스턴스 번호
+	TMap<UInstancedStaticMeshComponent*, int32> RingCursors;
+
+	struct FInstanceRef
+	{
+		UInstancedStaticMeshComponent* Comp;
+		int32 Index;
+
+		bool operator==(const FInstanceRef& Other) const { return Comp == Other.Comp && Index == Other.Index; }
+	};
+
+	// 반경 안의 자국을 물리 검사 없이 찾기 위한 격자. 칸마다 그 안에 있는 인스턴스들을 담습니다.
+	TMap<FIntVector, TArray<FInstanceRef>> Grid;
+
+	// 컴포넌트마다 인스턴스 번호 순서대로 담은 월드 위치
+	TMap<UInstancedStaticMeshComponent*, TArray<FVector>> InstanceLocations;
 };
@@ -0,0 +1,81 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#pragma once
+
+#include "GameFramework/Controller.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SaucewichBench.generated.h"
+
+class ATpsCharacter;
+
+/**
+ * -SaucewichBench 로 실행하면 실제 클라이언트 없이 봇끼리 게임을 진행하며 서버 부하를 CSV로 기록합니다.
+ * -BenchBots=N		봇 수 (기본: 게임 모드의 MaxPlayers)
+ * -BenchSeed=N		난수 시드 (기본: 0)
+ * -BenchSeconds=N	기록할 시간. 지나면 CSV를 쓰고 종료합니다. (기본: 120)
+ * -BenchCsv=Path	CSV 경로 (기본: Saved/Profiling/SaucewichBench-<시각>.csv)
+ * 봇에는 접속이 없어 리플리케이션 비용은 잡히지 않습니다. 네트워크 부하는 실제 클라이언트를 붙여서 재야 합니다.
+ */
+namespace SaucewichBench
+{
+	SAUCEWICH_API bool IsEnabled();
+	SAUCEWICH_API int32 GetNumBots(int32 Default);
+	SAUCEWICH_API int32 GetSeed();
+
+	// 시드를 전역 난수 생성기에 적용합니다. 맵마다 같은 순서로 진행되도록 게임 모드가 시작될 때 부릅니다.
+	SAUCEWICH_API void ApplySeed();
+
+	// 벤치마크 중에만 트레이스 수를 셉니다. 워커 스레드에서 불러도 됩니다.
+	SAUCEWICH_API void CountTraces(int32 Num = 1);
+
+	// 벤치마크 중에만 발사체 폭발을 알리는 RPC 수를 셉니다.
+	SAUCEWICH_API void CountImpactRPCs(int32 Num = 1);
+
+	// 벤치마크 중에만 서버가 받거나 내보내는 무기 입력 메시지 수를 셉니다. (RPC, 입력 상태 리플리케이션)
+	SAUCEWICH_API void CountInputMessages(int32 Num = 1);
+}
+
+/**
+ * 실제 플레이어와 같은 ATpsCharacter, UWeaponComponent 경로로 움직이고 쏘는 벤치마크용 봇입니다.
+ */
+UCLASS(NotBlueprintable, Transient)
+class SAUCEWICH_API ABenchBot : public AController
+{
+	GENERATED_BODY()
+
+public:
+	ABenchBot();
+	void SetSeed(int32 Seed) { Random.Initialize(Seed); }
+
+protected:
+	void Tick(float DeltaSeconds) override;
+
+private:
+	ATpsCharacter* FindTarget(const ATpsCharacter& Self) const;
+	void Respawn();
+
+	FRandomStream Random;
+	FTimerHandle RespawnTimer;
+	float WanderYaw = 0.f;
+	float NextWanderTime = 0.f;
+	float Strafe = 0.f;
+};
+
+/**
+ * 벤치마크 중 게임이 진행되는 월드에서 프레임마다 서버 부하를 기록합니다. 기록은 맵을 옮겨도 이어집니다.
+ */
+UCLASS()
+class SAUCEWICH_API UBenchRecorder final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	bool ShouldCreateSubsystem(UObject* Outer) const override;
+	void Deinitialize() override;
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	TStatId GetStatId() const override;
+};
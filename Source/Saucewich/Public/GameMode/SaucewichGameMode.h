@@ -92,6 +92,7 @@ public:
 	FString ChooseNextMap(const UWorld* World) const;
 
 	void SetPlayerRespawnTimer(ASaucewichPlayerController* PC) const;
+	float GetRespawnDelay() const { return MinRespawnDelay; }
 	void OnPlayerChangedName(class ASaucewichPlayerState* Player, FString&& OldName);
 
 protected:
@@ -124,6 +125,7 @@ protected:
 
 private:
 	bool EndMatchIfNoPlayers();
+	void SpawnBenchBots();
 	void UpdateMatchState();
 	USaucewichInstance* GetSaucewichInstance() const;
 	
@@ -3,9 +3,12 @@
 #pragma once
 
 #include "GameFramework/GameState.h"
+#include "CollisionQueryParams.h"
+#include "Weapon/AutoAim.h"
 #include "SaucewichGameState.generated.h"
 
 class AWeapon;
+class AProjectile;
 class ASauceMarker;
 class ATpsCharacter;
 class ASaucewichPlayerState;
@@ -19,6 +22,34 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnMatchStateChanged, FName, NewMatc
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnLeavingMap);
 DECLARE_EVENT(ASaucewichGameState, FOnCleanupGame)
 
+// 리플리케이트되는 발사체의 폭발 한 건. 위치와 법선은 양자화되어 전송됩니다.
+USTRUCT()
+struct FProjectileImpact
+{
+	GENERATED_BODY()
+
+	// 클라이언트가 이 액터를 받은 적이 없으면 null이므로, 연출은 Class의 기본값으로 합니다.
+	UPROPERTY()
+	AProjectile* Projectile;
+
+	UPROPERTY()
+	TSubclassOf<AProjectile> Class;
+
+	UPROPERTY()
+	FVector_NetQuantize Location;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Normal;
+
+	// 액터의 반납이 먼저 리플리케이트되면 팀이 초기화되어 있으므로 함께 보냅니다.
+	UPROPERTY()
+	uint8 Team;
+
+	// 폭발할 때 발사체의 활성화 횟수. 클라이언트에 도착했을 때 풀이 액터를 이미 다시 꺼내 썼는지 가려냅니다.
+	UPROPERTY()
+	uint8 Serial;
+};
+
 UCLASS()
 class SAUCEWICH_API ASaucewichGameState : public AGameState
 {
@@ -39,6 +70,21 @@ public:
 	UFUNCTION(BlueprintCallable)
 	uint8 GetNumPlayers(uint8 Team) const;
 
+	// 팀별 목록은 팀 변경, 빙의, 접속/퇴장 때만 갱신되므로 매번 PlayerArray를 훑지 않습니다.
+	TArrayView<ASaucewichPlayerState* const> GetTeamPlayers(uint8 Team) const;
+	TArrayView<ATpsCharacter* const> GetTeamCharacters(uint8 Team) const;
+
+	// 해당 팀의 캐릭터들을 모두 무시하는 충돌 검사 파라미터
+	const FCollisionQueryParams& GetTeamIgnoreParams(uint8 Team) const;
+
+	void UpdatePlayerTeam(ASaucewichPlayerState* Player);
+	void UpdateCharacterTeam(ATpsCharacter* Character);
+	void RemoveCharacter(ATpsCharacter* Character);
+
+	// 해당 팀의 살아있는 캐릭터들의 캡슐 스냅샷. 프레임마다 한 번만 갱신됩니다.
+	const FAutoAimSnapshot& GetAutoAimSnapshot(uint8 Team) const;
+	int32 GetNumTeams() const;
+
 	uint8 GetWinningTeam() const;
 	uint8 GetEmptyTeam() const;
 
@@ -48,6 +94,9 @@ public:
 
 	virtual bool CanAddPersonalScore() const;
 
+	// 서버에서 발사체 폭발을 모아 두었다가 다음 Tick에 한 번의 멀티캐스트로 보냅니다.
+	void AddImpact(AProjectile* Projectile, const FHitResult& Hit, uint8 Team);
+
 	UFUNCTION(NetMulticast, Reliable)
 	void MulticastPlayerDeath(ASaucewichPlayerState* Victim, ASaucewichPlayerState* Attacker, AActor* Inflictor);
 
@@ -56,11 +105,6 @@ public:
 	float GetRemainingRoundSeconds() const;
 	void SetRemainingRoundSeconds(float Time);
 
-	UFUNCTION(BlueprintCallable)
-	void AddDilatableActor(AActor* Actor) { DilatableActors.Add(Actor); }
-	void AddDilatablePSC(class UParticleSystemComponent* PSC) { DilatablePSCs.Add(PSC); }
-
-
 	UPROPERTY(BlueprintAssignable)
 	FOnPlayerChangedTeam OnPlayerChangedTeam;
 
@@ -90,26 +134,46 @@ protected:
 	void HandleMatchHasEnded() override;
 	void HandleLeavingMap() override;
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	void AddPlayerState(APlayerState* PlayerState) override;
+	void RemovePlayerState(APlayerState* PlayerState) override;
 	virtual void HandleMatchEnding();
 
 private:
+	struct FTeamRegistry
+	{
+		TArray<ASaucewichPlayerState*> Players;
+		TArray<ATpsCharacter*> Characters;
+		FCollisionQueryParams IgnoreParams;
+	};
+
+	FTeamRegistry& GetTeamRegistry(uint8 Team);
+	void UpdateIgnoreParams();
+	void FlushImpacts();
+
+	// 폭발 연출일 뿐이므로 유실되어도 괜찮습니다.
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastImpacts(const TArray<FProjectileImpact>& Impacts);
+
 	const FGameData& GetGmData() const;
+	void PrewarmActorPool() const;
 	
 	UFUNCTION()
 	void OnRep_WonTeam() const;
 
-	UPROPERTY(Transient)
-	TSet<UParticleSystemComponent*> DilatablePSCs;
-
 	UPROPERTY(Replicated, Transient, VisibleInstanceOnly)
 	TArray<int32> TeamScore;
 
-	UPROPERTY(Transient)
-	TArray<AActor*> DilatableActors;
-
 	UPROPERTY(BlueprintAssignable)
 	FOnMatchStateChanged OnMatchStateChanged;
 
+	TArray<FTeamRegistry> TeamRegistry;
+
+	UPROPERTY(Transient)
+	TArray<FProjectileImpact> PendingImpacts;
+
+	mutable TArray<FAutoAimSnapshot> AutoAimSnapshots;
+	mutable uint64 AutoAimSnapshotFrame = 0;
+
 	FTimerHandle RoundTimer;
 	FTextFormat TeamScoreAddMsgFmt;
 	
@@ -0,0 +1,95 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "TimeDilationSubsystem.generated.h"
+
+class UParticleSystemComponent;
+
+UENUM()
+enum class EDilationGroup : uint8
+{
+	Gameplay,	// 캐릭터, 무기, 발사체, 픽업
+	Effects,	// 한 번 재생되고 끝나는 파티클
+	Num UMETA(Hidden)
+};
+
+// UTimeDilationSubsystem에 등록된 액터나 파티클을 가리킵니다. 해제된 뒤 같은 자리에 다른 것이 등록되어도 Serial로 구별됩니다.
+struct FDilationHandle
+{
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+private:
+	friend class UTimeDilationSubsystem;
+
+	int32 Index = INDEX_NONE;
+	uint32 Serial = 0;
+	EDilationGroup Group = EDilationGroup::Gameplay;
+};
+
+/**
+ * 그룹별 시간 배율을 한 곳에서 관리합니다. 매치가 끝날 때의 슬로 모션이 이 배율로 적용됩니다.
+ * 풀 액터는 활성화되어 있는 동안만 등록되고, 파티클은 재생이 끝나면 스스로 빠지며, 파괴된 것은 Tick마다 조금씩 정리됩니다.
+ * 배율이 바뀌지 않는 프레임에는 정해진 개수만 훑으므로 매치 동안 쌓인 액터 수와 무관합니다.
+ */
+UCLASS()
+class SAUCEWICH_API UTimeDilationSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static UTimeDilationSubsystem* Get(const UObject* WorldContextObject);
+
+	// 등록하는 즉시 그룹의 배율이 적용됩니다.
+	FDilationHandle Register(AActor* Actor, EDilationGroup Group = EDilationGroup::Gameplay);
+
+	// 파티클은 재생이 끝나면 알아서 해제되므로 핸들을 보관하지 않아도 됩니다.
+	FDilationHandle Register(UParticleSystemComponent* PSC, EDilationGroup Group = EDilationGroup::Effects);
+
+	// 배율을 1로 되돌리고 해제합니다. Handle은 무효화됩니다.
+	void Unregister(FDilationHandle& Handle);
+
+	void SetScale(EDilationGroup Group, float Scale);
+	float GetScale(const EDilationGroup Group) const { return Groups[static_cast<int32>(Group)].Scale; }
+
+	void Deinitialize() override;
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	TStatId GetStatId() const override;
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AActor> Actor;
+		TWeakObjectPtr<UParticleSystemComponent> PSC;
+		uint32 Serial;
+	};
+
+	struct FGroup
+	{
+		TSparseArray<FEntry> Entries;
+		float Scale = 1.f;
+
+		// 등록된 것들에 마지막으로 적용한 배율
+		float AppliedScale = 1.f;
+
+		// 정리할 차례인 다음 인덱스
+		int32 Cursor = 0;
+	};
+
+	FDilationHandle Add(EDilationGroup Group, const FEntry& Entry);
+	void Remove(FGroup& Group, int32 Index, bool bRestore);
+	void Apply(FGroup& Group);
+	void Sweep(FGroup& Group, int32 Budget);
+
+	UFUNCTION()
+	void OnSystemFinished(UParticleSystemComponent* PSC);
+
+	FGroup Groups[static_cast<int32>(EDilationGroup::Num)];
+	int32 NumEntries = 0;
+	uint32 NextSerial = 0;
+};
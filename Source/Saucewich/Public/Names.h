@@ -28,4 +28,5 @@ namespace Names
 	extern const FName Win;
 	extern const FName Draw;
 	extern const FName Lose;
+	extern const FName Cosmetic;
 }
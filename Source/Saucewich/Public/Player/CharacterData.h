@@ -12,6 +12,7 @@ class SAUCEWICH_API UCharacterData : public UDataAsset
 
 public:
 	class UMaterialInterface* GetTranslMat(uint8 Idx, const UMaterialInterface* Mat) const;
+	void GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const;
 
 	UPROPERTY(EditAnywhere)
 	TArray<TSoftObjectPtr<class USoundBase>> DeathSounds;
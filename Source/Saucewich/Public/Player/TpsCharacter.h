@@ -3,6 +3,7 @@
 #pragma once
 
 #include "GameFramework/Character.h"
+#include "GameMode/TimeDilationSubsystem.h"
 #include "Saucewich.h"
 #include "TpsCharacter.generated.h"
 
@@ -35,6 +36,7 @@ class SAUCEWICH_API ATpsCharacter : public ACharacter
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta=(AllowPrivateAccess=true))
 	class UCameraComponent* Camera;
 
+	// 데디케이티드 서버에서는 null입니다.
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, meta=(AllowPrivateAccess=true))
 	class UShadowComponent* Shadow;
 
@@ -44,6 +46,7 @@ public:
 	USpringArmComponent* GetSpringArm() const { return SpringArm; }
 	UCameraComponent* GetCamera() const { return Camera; }
 	UWeaponComponent* GetWeaponComponent() const { return WeaponComponent; }
+	const class UCharacterData* GetCharacterData() const { return Data; }
 
 	class AWeapon* GetActiveWeapon() const;
 
@@ -151,6 +154,7 @@ private:
 	FOnHPChanged OnHPChanged;
 
 	FTimerHandle RespawnInvincibleTimer;
+	FDilationHandle DilationHandle;
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta=(AllowPrivateAccess=true))
 	const class UCharacterData* Data;
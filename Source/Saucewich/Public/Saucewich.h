@@ -11,7 +11,10 @@
 DECLARE_LOG_CATEGORY_EXTERN(LogSaucewich, Log, All)
 DECLARE_LOG_CATEGORY_EXTERN(LogGameLift, Log, All)
 
+DECLARE_STATS_GROUP(TEXT("Saucewich"), STATGROUP_Saucewich, STATCAT_Advanced);
+
 class FGameLiftServerSDKModule;
+class UActorComponent;
 
 UENUM(BlueprintType)
 enum class EMsgType : uint8
@@ -31,6 +34,54 @@ namespace GameLift
 	void SafeTerminate();
 }
 
+namespace SyncLoad
+{
+	// 매치 진행 중(MatchState::InProgress)에 일어난 동기 로딩을 히치로 보고합니다.
+	SAUCEWICH_API void Report(const UObject* WorldContextObject, const FSoftObjectPath& Path, double Seconds);
+
+	// 이미 로드되어 있으면 그대로 반환하고, 아니면 동기 로딩한 뒤 걸린 시간을 Report합니다.
+	template <class TSoftPtr>
+	auto Load(const TSoftPtr& Soft, const UObject* WorldContextObject)
+	{
+		if (const auto Loaded = Soft.Get()) return Loaded;
+		if (Soft.IsNull()) return decltype(Soft.Get()){};
+
+		const auto Start = FPlatformTime::Seconds();
+		const auto Loaded = Soft.LoadSynchronous();
+		Report(WorldContextObject, Soft.ToSoftObjectPath(), FPlatformTime::Seconds() - Start);
+		return Loaded;
+	}
+}
+
+namespace Cosmetic
+{
+	// 보여주기만 하는 컴포넌트나 이펙트를 만들어야 하는지. 데디케이티드 서버에서는 false입니다.
+	SAUCEWICH_API bool IsEnabled(const UObject* WorldContextObject);
+
+	SAUCEWICH_API void MarkComponent(UActorComponent* Component);
+
+	// 생성자에서 씁니다. 데디케이티드 서버 프로세스에서는 아예 만들지 않고 null을 반환하므로 사용하는 쪽에서 확인해야 합니다.
+	template <class T>
+	T* CreateSubobject(UObject* const Outer, const FName Name)
+	{
+		if (IsRunningDedicatedServer()) return nullptr;
+		const auto Component = Outer->CreateOptionalDefaultSubobject<T>(Name);
+		if (Component) MarkComponent(Component);
+		return Component;
+	}
+
+	// PIE처럼 프로세스는 클라이언트인데 월드가 데디케이티드 서버인 경우를 위해 PostInitializeComponents에서 부릅니다.
+	template <class T>
+	void Strip(const UObject* const Owner, T*& Component)
+	{
+		if (Component && !IsEnabled(Owner))
+		{
+			Component->DestroyComponent();
+			Component = nullptr;
+		}
+	}
+}
+
 UCLASS()
 class SAUCEWICH_API USaucewich : public UBlueprintFunctionLibrary
 {
@@ -5,12 +5,14 @@
 #include "Engine/GameInstance.h"
 #include "Engine/EngineTypes.h"
 #include "UObject/TextProperty.h"
+#include "Entity/ActorPool.h"
 #include "SaucewichInstance.generated.h"
 
 class AWeapon;
 class AActorPool;
 class ASauceMarker;
 class ASaucewichGameMode;
+struct FStreamableHandle;
 
 #if WITH_GAMELIFT
 namespace Aws {
@@ -52,6 +54,9 @@ public:
 	AActorPool* GetActorPool() const;
 	ASauceMarker* GetSauceMarker() const;
 	auto&& GetGameModes() const { return GameModes; }
+	auto&& GetPrimaryWeapons() const { return PrimaryWeapons; }
+	auto&& GetSecondaryWeapons() const { return SecondaryWeapons; }
+	auto&& GetPoolBudgets() const { return PoolBudgets; }
 	auto&& GetScoreData(const FName& ID) const { return ScoreData[ID]; }
 	ECollisionChannel GetDecalTraceChannel() const { return DecalTraceChannel; }
 
@@ -62,11 +67,21 @@ public:
 	void StartupServer();
 	void OnGameReady();
 
+	/**
+	 * 게임 모드, 무기, 캐릭터 데이터와 그것들이 참조하는 발사체, 사운드, 이펙트를 한꺼번에 비동기로 로드합니다.
+	 * 클래스가 로드되어야 그 안의 참조를 알 수 있으므로 새로운 참조가 없을 때까지 단계별로 진행합니다.
+	 * 로드된 에셋은 게임 인스턴스가 살아있는 동안 유지됩니다.
+	 */
+	void PreloadAssets();
+
 protected:
 	void Init() override;
 
 private:
 	void OnNetworkError(UWorld*, class UNetDriver*, ENetworkFailure::Type, const FString&);
+	void OnSeamlessTravelStart(UWorld* World, const FString& MapName);
+	void RequestPreload(TArray<FSoftObjectPath>&& Paths);
+	void OnPreloaded(TArray<FSoftObjectPath> Loaded);
 	
 	UPROPERTY(EditDefaultsOnly)
 	TMap<FName, FScoreData> ScoreData;
@@ -82,6 +97,10 @@ private:
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, meta=(AllowPrivateAccess=true))
 	TArray<TSoftClassPtr<AWeapon>> SecondaryWeapons;
+
+	// 맵 로드 시 액터 풀에 적용할 클래스별 예산. 총알은 FGunData로부터 자동으로 계산되며, 여기 지정하면 덮어씁니다.
+	UPROPERTY(EditDefaultsOnly)
+	TArray<FActorPoolBudget> PoolBudgets;
 	
 	UPROPERTY(Transient)
 	mutable AActorPool* ActorPool;
@@ -98,6 +117,9 @@ private:
 	UPROPERTY(EditDefaultsOnly)
 	TEnumAsByte<ECollisionChannel> DecalTraceChannel;
 
+	TArray<TSharedPtr<FStreamableHandle>> PreloadHandles;
+	TSet<FSoftObjectPath> PreloadedPaths;
+
 	struct
 	{
 		FText Msg;
@@ -0,0 +1,68 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#pragma once
+
+#include "ReplicationGraph.h"
+#include "SaucewichReplicationGraph.generated.h"
+
+class AWeapon;
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_AlwaysRelevant_ForConnection;
+
+enum class EClassRepNodeMapping : uint32
+{
+	NotRouted,				// 다른 액터에 딸려서만 리플리케이트됩니다. (무기)
+	RelevantAllConnections,	// 모든 연결에 항상 리플리케이트됩니다. (게임 스테이트, 플레이어 스테이트)
+	Spatialize_Static,		// 움직이지 않는 액터
+	Spatialize_Dynamic,		// 매 프레임 위치가 갱신되는 액터 (캐릭터, 발사체)
+	Spatialize_Dormancy,	// 휴면 중에는 정적으로, 깨어나면 동적으로 다뤄지는 액터 (픽업, 풀에 들어간 액터)
+};
+
+/**
+ * Saucewich 액터 종류에 맞춘 리플리케이션 그래프입니다.
+ * 발사체와 픽업은 공간 격자로, 게임 스테이트는 항상 관련 있는 노드로 보내고, 무기는 주인 캐릭터에 딸려 리플리케이트됩니다.
+ * Config/DefaultEngine.ini의 ReplicationDriverClassName으로 켜집니다.
+ */
+UCLASS(Transient, Config=Engine)
+class SAUCEWICH_API USaucewichReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	void ResetGameWorldState() override;
+
+	void InitGlobalActorClassSettings() override;
+	void InitGlobalGraphNodes() override;
+	void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+	void RemoveClientConnection(UNetConnection* NetConnection) override;
+	void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+	void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	int32 ServerReplicateActors(float DeltaSeconds) override;
+
+protected:
+	void BeginDestroy() override;
+
+private:
+	EClassRepNodeMapping GetMappingPolicy(UClass* Class);
+	void InitClassReplicationInfo(FClassReplicationInfo& Info, UClass* Class, bool bSpatialize) const;
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* GetAlwaysRelevantNode(UNetConnection* Connection) const;
+	void OnWeaponOwnerChanged(AWeapon* Weapon, AActor* OldOwner, AActor* NewOwner);
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	UPROPERTY()
+	TMap<UNetConnection*, UReplicationGraphNode_AlwaysRelevant_ForConnection*> ConnectionNodes;
+
+	// 연결이 아직 정해지지 않아 연결별 노드에 넣지 못한 주인 전용 액터 (플레이어 컨트롤러 등)
+	UPROPERTY()
+	TArray<AActor*> ActorsWithoutNetConnection;
+
+	TClassMap<EClassRepNodeMapping> ClassRepNodePolicies;
+	FDelegateHandle WeaponOwnerChangedHandle;
+};
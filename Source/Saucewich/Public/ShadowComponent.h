@@ -5,6 +5,9 @@
 #include "Components/StaticMeshComponent.h"
 #include "ShadowComponent.generated.h"
 
+/**
+ * 바닥에 붙는 원형 그림자입니다. 직접 Tick하지 않고 UShadowSubsystem이 정해진 예산 안에서 갱신합니다.
+ */
 UCLASS()
 class SAUCEWICH_API UShadowComponent : public UStaticMeshComponent
 {
@@ -14,13 +17,25 @@ public:
 	UShadowComponent();
 
 #if !UE_SERVER
+	// 주인이 Threshold보다 많이 움직였거나 MaxInterval초 넘게 갱신되지 않았으면 true
+	bool NeedsUpdate(float Threshold, float MaxInterval, float Now) const;
+
+	// 그림자를 다시 계산하고 사용한 트레이스 수를 반환합니다.
+	int32 UpdateShadow(float Now);
 		
 protected:
 	void BeginPlay() override;
-	void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	void EndPlay(EEndPlayReason::Type EndPlayReason) override;
 	
 private:
+	FVector GetTraceStart() const;
+	void SetMaterialParams(float NewDist, float NewOpacity);
+
 	FTransform Offset;
+	FVector LastStart = FVector::ZeroVector;
+	float LastUpdateTime = -MAX_flt;
+	float Dist = -1.f;
+	float Opacity = -1.f;
 
 #endif
 };
@@ -0,0 +1,39 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ShadowSubsystem.generated.h"
+
+class UShadowComponent;
+
+/**
+ * 모든 UShadowComponent를 한곳에서 갱신합니다.
+ * 주인이 움직인 그림자만 다시 계산하고, 프레임당 트레이스 예산을 넘는 것은 다음 프레임으로 미룹니다.
+ */
+UCLASS()
+class SAUCEWICH_API UShadowSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static UShadowSubsystem* Get(const UObject* WorldContextObject);
+
+	void Register(UShadowComponent* Shadow);
+	void Unregister(UShadowComponent* Shadow);
+
+	bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	TStatId GetStatId() const override;
+
+private:
+	UPROPERTY(Transient)
+	TArray<UShadowComponent*> Shadows;
+
+	// 예산이 모자라 미뤄진 그림자부터 갱신하기 위한 시작 위치
+	int32 Cursor = 0;
+};
@@ -0,0 +1,57 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class ATpsCharacter;
+
+/**
+ * 한 팀의 살아있는 캐릭터 캡슐을 SoA로 담은 스냅샷입니다.
+ * 배열은 4개 단위로 SIMD 처리할 수 있도록 절대 선택되지 않는 값으로 채워집니다.
+ */
+struct SAUCEWICH_API FAutoAimSnapshot
+{
+	void Reset();
+	void Add(const ATpsCharacter* Character);
+	void Pad();
+
+	int32 Num() const { return Characters.Num(); }
+
+	TArray<float, TAlignedHeapAllocator<16>> X, Y, Z;
+	TArray<float, TAlignedHeapAllocator<16>> Radius;
+
+	// 캡슐에서 반구를 제외한 원기둥 부분의 절반 높이
+	TArray<float, TAlignedHeapAllocator<16>> Segment;
+
+	TArray<ATpsCharacter*> Characters;
+};
+
+struct FAutoAimQuery
+{
+	FVector Start;
+	FVector Dir;
+	FVector Right;
+	FVector Up;
+	float MaxDistance;
+
+	// 조준 방향에 수직인 상자의 절반 크기 (Right, Up)
+	FVector2D BoxSize;
+};
+
+struct FAutoAimCandidate
+{
+	// 조준 방향으로의 거리
+	float Distance;
+	ATpsCharacter* Character;
+
+	bool operator<(const FAutoAimCandidate& Other) const { return Distance < Other.Distance; }
+};
+
+using FAutoAimCandidates = TArray<FAutoAimCandidate, TInlineAllocator<8>>;
+
+namespace AutoAim
+{
+	// 조준 상자와 겹치는 캡슐들을 OutCandidates에 추가합니다. 정렬은 호출하는 쪽에서 합니다.
+	SAUCEWICH_API void Cull(const FAutoAimSnapshot& Snapshot, const FAutoAimQuery& Query, FAutoAimCandidates& OutCandidates);
+}
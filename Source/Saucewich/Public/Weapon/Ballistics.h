@@ -0,0 +1,48 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 여러 목표의 위치와 속도를 SoA로 담습니다.
+ * 배열은 4개 단위로 SIMD 처리할 수 있도록 채워집니다.
+ */
+struct SAUCEWICH_API FBallisticTargets
+{
+	void Reset();
+	void Add(const FVector& Location, const FVector& Velocity);
+	void Pad();
+
+	int32 Num() const { return NumTargets; }
+
+	TArray<float, TAlignedHeapAllocator<16>> X, Y, Z;
+	TArray<float, TAlignedHeapAllocator<16>> VX, VY, VZ;
+
+private:
+	int32 NumTargets = 0;
+};
+
+struct FBallisticSolution
+{
+	// 발사 방향 (단위 벡터)
+	FVector Dir;
+
+	// 발사 후 목표에 닿을 때까지의 시간. 풀 수 없으면 음수입니다.
+	float Time;
+
+	bool IsValid() const { return Time > 0.f; }
+};
+
+namespace Ballistics
+{
+	/**
+	 * Start에서 Speed로 발사되어 GravityZ만큼 떨어지는 발사체가, Location에서 Velocity로 등속 운동하는 목표에 닿는 방향을 구합니다.
+	 * 고저차와 중력을 그대로 반영하며, |D + Vt - gt²/2| = Speed * t 를 고정된 횟수만큼 반복해서 풉니다.
+	 * 사거리 밖이라 닿을 수 없으면 false를 반환합니다.
+	 */
+	SAUCEWICH_API bool Solve(const FVector& Start, float Speed, float GravityZ, const FVector& Location, const FVector& Velocity, FBallisticSolution& OutSolution);
+
+	// Solve와 같은 계산을 목표 4개씩 SIMD로 합니다. OutSolutions는 Targets.Num()개가 됩니다.
+	SAUCEWICH_API void SolveBatch(const FVector& Start, float Speed, float GravityZ, const FBallisticTargets& Targets, TArray<FBallisticSolution>& OutSolutions);
+}
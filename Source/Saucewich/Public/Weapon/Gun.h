@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include "Weapon/AutoAim.h"
 #include "Weapon/Weapon.h"
 #include "Gun.generated.h"
 
@@ -118,6 +119,26 @@ struct SAUCEWICH_API FGunData : public FWeaponData
 	uint8 NumProjectile = 1;
 };
 
+// 클라이언트가 자신이 쏜 발사체로 캐릭터를 맞혔을 때 서버에 보내는 보고
+USTRUCT()
+struct FGunHitReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	class ATpsCharacter* Victim;
+
+	UPROPERTY()
+	FVector_NetQuantize ImpactPoint;
+
+	UPROPERTY()
+	FVector_NetQuantizeNormal Direction;
+
+	// 맞은 시점의 서버 시간
+	UPROPERTY()
+	float HitTime;
+};
+
 UCLASS(Abstract)
 class SAUCEWICH_API AGun : public AWeapon
 {
@@ -128,6 +149,9 @@ public:
 
 	UFUNCTION(BlueprintCallable)
 	static const FGunData& GetGunDataFromClass(TSubclassOf<AGun> Class);
+
+	// 플레이어 한 명이 이 총을 계속 쏠 때 동시에 존재하는 발사체 수의 추정치입니다.
+	static int32 EstimateLiveProjectiles(TSubclassOf<AGun> Class);
 	
 	UFUNCTION(BlueprintCallable)
 	const FGunData& GetGunData() const;
@@ -135,7 +159,23 @@ public:
 	UFUNCTION(BlueprintCallable)
 	bool GunTrace(FHitResult& OutHit);
 
+	// 물리 쿼리 없이 캐시된 캡슐 스냅샷만으로 조준 상자 안에 있는 가장 가까운 적을 찾습니다.
+	// 시야는 확인하지 않으므로 GunTrace보다 훨씬 싸지만, 벽 뒤의 적도 반환할 수 있습니다.
+	class ATpsCharacter* FindAutoAimCandidate() const;
+
+	// 로드된 에셋을 반환합니다. 아직 로드되지 않았으면 동기 로딩하며, 매치 중이라면 히치로 보고됩니다.
+	TSubclassOf<AGunProjectile> GetProjectileClass() const;
+	TSubclassOf<UDamageType> GetDamageType() const;
+	USoundBase* GetFireSound() const;
+	TSubclassOf<UCameraShake> GetFireShake() const;
+
+	void GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const override;
+
+	// 로컬 플레이어가 쏜 발사체의 명중을 서버에 보고합니다. 보고는 Tick에서 모아 보내며, 서버는 히트박스 기록으로 검증한 뒤 데미지를 줍니다.
+	void ReportHit(const FHitResult& Hit, const FVector& Direction);
+
 protected:
+	void PostInitializeComponents() override;
 	void BeginPlay() override;
 	void Tick(float DeltaSeconds) override;
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
@@ -149,13 +189,29 @@ protected:
 	void OnActivated() override;
 	void OnReleased() override;
 
+	void OnAssetsLoaded() override;
+
 	void SetColor(const FLinearColor& NewColor) override;
 
 	UFUNCTION(BlueprintImplementableEvent)
 	void OnShoot();
 
 private:
-	void Shoot();
+	// 한 프레임 동안 발사한 발사체를 모아 한 번에 생성합니다.
+	struct FShotBatch
+	{
+		TArray<FTransform, TInlineAllocator<16>> Transforms;
+
+		// 각 발사체가 프레임 끝보다 몇 초 먼저 발사되었는지
+		TArray<float, TInlineAllocator<16>> Ages;
+	};
+
+	void Shoot(FShotBatch& Batch, const FTransform& MuzzleTransform, const FQuat& Rotation, float Age);
+	void FlushShots(const FShotBatch& Batch);
+
+	// 탄퍼짐 감소와 재장전은 프레임레이트에 관계없이 같은 결과가 나오도록 고정된 간격으로 진행합니다.
+	void FixedTick(float Step);
+
 	void StartFire(int32 RandSeed);
 
 	UFUNCTION(Server, Reliable, WithValidation)
@@ -164,7 +220,14 @@ private:
 	UFUNCTION(NetMulticast, Reliable)
 	void MulticastStartFire(int32 RandSeed);
 
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerReportHits(const TArray<FGunHitReport>& Reports);
+	void ApplyHitReport(const FGunHitReport& Report);
+
 	bool GunTraceInternal(FHitResult& OutHit, FName ProjColProf, const FGunData& Data);
+	bool GunTraceSweep(FHitResult& OutHit, const FGunData& Data, const class ATpsCharacter* Character);
+	bool GunTraceCull(FHitResult& OutHit, const FGunData& Data, const ATpsCharacter* Character);
+	bool CullAutoAim(FAutoAimQuery& OutQuery, FAutoAimCandidates& OutCandidates) const;
 
 	UFUNCTION()
 	void OnRep_Dried() const;
@@ -175,17 +238,52 @@ private:
 	UPROPERTY(BlueprintAssignable)
 	FOnGunClipChanged OnClipChanged;
 
+	// 데디케이티드 서버에서는 null입니다.
 	UPROPERTY(VisibleAnywhere)
 	class UParticleSystemComponent* FirePSC;
 
+	// 같은 프레임에 무기 컴포넌트, 애님 인스턴스, 발사가 같은 조준으로 GunTrace를 여러 번 하므로 결과를 재사용합니다.
+	struct FGunTraceCache
+	{
+		FHitResult Hit;
+		FRotator Aim;
+		uint64 Frame = 0;
+		bool bHit = false;
+		bool bValid = false;
+	} TraceCache;
+
+	UPROPERTY(Transient)
+	mutable TSubclassOf<AGunProjectile> ProjectileClass;
+
+	UPROPERTY(Transient)
+	mutable TSubclassOf<UDamageType> DamageType;
+
+	UPROPERTY(Transient)
+	mutable USoundBase* FireSound;
+
+	UPROPERTY(Transient)
+	mutable TSubclassOf<UCameraShake> FireShake;
+
 	FRandomStream FireRand;
 	float SpreadAlpha;
 
 	float FireLag;
+	float StepLag;
+
+	// 발사 시각에 맞춰 총구 위치를 보간하기 위한 이전 프레임의 트랜스폼
+	FTransform LastMuzzleTransform;
+	FQuat LastRotation;
+	uint64 LastTransformFrame;
 
 	float ReloadWaitingTime;
 	float ReloadAlpha;
 
+	// 서버에서 이 총이 아직 보고받지 않은 발사체 수. 쏜 것보다 많은 명중 보고는 거부합니다.
+	uint16 HitCredits;
+
+	// Tick 끝에서 ServerReportHits로 한 번에 보낼 명중 보고
+	TArray<FGunHitReport> PendingHitReports;
+
 	UPROPERTY(ReplicatedUsing=OnRep_Clip, Transient, EditInstanceOnly, BlueprintReadOnly, meta=(AllowPrivateAccess=true))
 	uint8 Clip;
 	uint8 LastClip;
@@ -0,0 +1,55 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "HitboxHistory.generated.h"
+
+class ATpsCharacter;
+
+/**
+ * 서버에서 캐릭터 캡슐의 최근 위치를 기록해 두고, 클라이언트가 보고한 명중을 그 시점으로 되돌려 검증합니다.
+ * Saucewich.LagComp.ClientHits가 0이면 기존처럼 서버가 시뮬레이션한 발사체로만 데미지를 줍니다.
+ */
+UCLASS()
+class SAUCEWICH_API UHitboxHistory final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static UHitboxHistory* Get(const UObject* WorldContextObject);
+	static bool IsEnabled();
+
+	// Time(서버 시간)에 Victim의 캡슐이 Point와 허용 오차 안에 있었는지 확인합니다.
+	bool Validate(const ATpsCharacter* Victim, float Time, const FVector& Point) const;
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	TStatId GetStatId() const override;
+
+private:
+	static constexpr auto NumSamples = 32;
+
+	struct FSample
+	{
+		float Time;
+		FVector Location;
+	};
+
+	struct FTrack
+	{
+		FSample Samples[NumSamples];
+		int32 Head = 0;
+		int32 Num = 0;
+		float Radius;
+		float Segment;
+		uint64 Frame;
+
+		void Add(float Time, const FVector& Location);
+		bool Find(float Time, FVector& OutLocation) const;
+	};
+
+	TMap<const ATpsCharacter*, FTrack> Tracks;
+};
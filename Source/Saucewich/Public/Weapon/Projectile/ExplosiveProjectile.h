@@ -10,9 +10,13 @@ class SAUCEWICH_API AExplosiveProjectile : public AProjectile
 {
 	GENERATED_BODY()
 
+public:
+	void GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const override;
+
 protected:
 	float GetSauceMarkScale() const override;
 	void OnExplode(const FHitResult& Hit) override;
+	void PlayImpactEffects(const AActor* Context, const FHitResult& Hit, const FVector& Location, uint8 EffectTeam) const override;
 	
 private:
 	UPROPERTY(EditAnywhere)
@@ -5,17 +5,38 @@
 #include "Weapon/Projectile/Projectile.h"
 #include "GunProjectile.generated.h"
 
+class AGun;
+
 UCLASS()
 class SAUCEWICH_API AGunProjectile : public AProjectile
 {
 	GENERATED_BODY()
 
+public:
+	AGunProjectile();
+
+	// 발사체가 Hit에 맞았을 때의 데미지를 Gun으로부터 계산해서 적용합니다. TravelTime은 발사 후 지난 시간입니다.
+	static void ApplyDamage(AGun& Gun, float TravelTime, const FHitResult& Hit, const FVector& Direction);
+
+	// 이 기기에서 시뮬레이션한 발사체가 맞았을 때 호출합니다.
+	// 원격 플레이어가 쏜 발사체가 캐릭터에 맞은 경우 서버는 데미지를 주지 않고 그 클라이언트의 보고를 기다립니다.
+	static void HandleImpact(AGun& Gun, float TravelTime, const FHitResult& Hit, const FVector& Direction);
+
 protected:
 	float GetSauceMarkScale() const override;
 	void OnActivated() override;
+	void OnReleased() override;
 	void OnExplode(const FHitResult& Hit) override;
 	void NotifyHit(UPrimitiveComponent* MyComp, AActor* Other, UPrimitiveComponent* OtherComp, bool bSelfMoved, FVector HitLocation, FVector HitNormal, FVector NormalImpulse, const FHitResult& Hit) override;
 
 private:
+	friend class UProjectileSubsystem;
+
+	// UProjectileSubsystem이 움직이는 동안에는 이 액터의 이동과 충돌을 끕니다.
+	void AttachToSimulation(int32 Index);
+
 	float FiredTime;
+
+	// UProjectileSubsystem에서의 인덱스. 이 액터가 직접 움직이고 있으면 INDEX_NONE입니다.
+	int32 SimIndex = INDEX_NONE;
 };
@@ -27,12 +27,17 @@ public:
 	UProjectileMovementComponent* GetMovement() const { return Movement; }
 	bool IsTeamValid() const { return Team != static_cast<decltype(Team)>(-1); }
 
+	// 폭발할 때 사용하는 에셋들. CDO에서도 호출할 수 있습니다.
+	virtual void GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const;
+
 	UFUNCTION(BlueprintCallable)
 	void Explode(const FHitResult& Hit);
 	virtual bool CanExplode(const FHitResult& Hit) const;
 
+	// 클라이언트에서 ASaucewichGameState가 모아 보낸 폭발을 처리합니다. 발사체 액터가 없어도 연출은 합니다.
+	static void ReceiveImpact(const AActor* Context, const struct FProjectileImpact& Impact);
+
 protected:
-	void BeginPlay() override;
 	void OnActivated() override;
 	void OnReleased() override;
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
@@ -40,10 +45,17 @@ protected:
 	virtual float GetSauceMarkScale() const { return 1.f; }
 	virtual void OnExplode(const FHitResult& Hit);
 
+	// 소리, 파티클, 진동, 소스 자국처럼 보여주기 위한 것만 합니다. 액터의 상태는 바꾸지 않습니다.
+	// CDO에서도 호출할 수 있으며, 월드는 Context에서 얻습니다.
+	virtual void PlayImpactEffects(const AActor* Context, const FHitResult& Hit, const FVector& Location, uint8 EffectTeam) const;
+
 	UFUNCTION()
 	void OnRep_Team() const;
 
 private:
+	static FLinearColor GetColor(const UObject* WorldContextObject, uint8 InTeam);
+	void ExplodeFromImpact(const struct FProjectileImpact& Impact, const FHitResult& Hit);
+
 	UFUNCTION(NetMulticast, Reliable)
 	void MulticastExplode(const FHitResult& Hit);
 	
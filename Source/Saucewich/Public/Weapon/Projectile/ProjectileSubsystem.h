@@ -0,0 +1,89 @@
+// Copyright 2019-2020 Seokjin Lee. All Rights Reserved.
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "ProjectileSubsystem.generated.h"
+
+class AGun;
+class AGunProjectile;
+
+/**
+ * 총에서 발사된 발사체들을 UProjectileMovementComponent 없이 SoA 배열로 한 번에 시뮬레이션합니다.
+ * 데디케이티드 서버에서는 액터를 만들지 않으며, 그 외에는 보여주기 위한 액터만 붙여서 위치를 갱신합니다.
+ * Saucewich.Projectile.Simulate가 0이면 기존처럼 액터가 직접 움직입니다.
+ */
+UCLASS()
+class SAUCEWICH_API UProjectileSubsystem final : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	static UProjectileSubsystem* Get(const UObject* WorldContextObject);
+	static bool IsEnabled();
+
+	// Ages는 각 발사체가 이번 프레임 끝보다 몇 초 먼저 발사되었는지입니다. 비어 있으면 모두 프레임 시작에 발사된 것으로 봅니다.
+	void Fire(AGun* Gun, TSubclassOf<AGunProjectile> Class, TArrayView<const FTransform> Transforms, const struct FActorSpawnParameters& SpawnParameters, TArrayView<const float> Ages = {});
+	int32 GetNum() const { return Positions.Num(); }
+
+	void Deinitialize() override;
+
+	void Tick(float DeltaTime) override;
+	bool IsTickable() const override;
+	UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	TStatId GetStatId() const override;
+
+private:
+	friend AGunProjectile;
+
+	struct FClassInfo
+	{
+		FName Profile;
+		float Radius;
+		float GravityScale;
+		float LifeSpan;
+	};
+
+	const FClassInfo& GetClassInfo(UClass* Class);
+	bool Sweep(int32 Index, FHitResult& OutHit) const;
+	void Resolve(int32 Index, const FHitResult& Hit);
+	void ReleaseVisual(int32 Index);
+	void DetachVisual(int32 Index);
+	void Remove(int32 Index);
+	void Clear();
+
+	TArray<FVector> Positions;
+	TArray<FVector> Velocities;
+	TArray<float> GravityZ;
+	TArray<float> Radii;
+	TArray<float> FiredTimes;
+	TArray<float> ExpireTimes;
+
+	// 발사된 뒤 처음 Tick에서 적분할 시간. 음수면 이미 한 번 적분한 발사체입니다.
+	TArray<float> FirstSteps;
+	TArray<FName> Profiles;
+	TArray<uint8> Teams;
+
+	UPROPERTY(Transient)
+	TArray<AGun*> Guns;
+
+	// 보여주기 위한 액터. 데디케이티드 서버에서는 항상 null입니다.
+	UPROPERTY(Transient)
+	TArray<AGunProjectile*> Visuals;
+
+	// Tick에서만 쓰는 임시 배열
+	TArray<FVector> Ends;
+	TArray<float> Steps;
+	TArray<FHitResult> Hits;
+	TArray<uint8> bHits;
+	TArray<int32> Removed;
+
+	TMap<UClass*, FClassInfo> ClassInfos;
+	FDelegateHandle CleanupHandle;
+
+	// 이 서브시스템이 시뮬레이션한 시간. 시간 감속이 반영되어 있습니다.
+	float SimTime = 0.f;
+
+	bool bTicking = false;
+};
@@ -32,6 +32,8 @@ public:
 	UFUNCTION(BlueprintCallable)
 	float GetRemainingReloadTime() const;
 
+	void GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const override;
+
 protected:
 	void SlotP() override;
 	void OnReleased() override;
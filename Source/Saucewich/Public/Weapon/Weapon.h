@@ -6,10 +6,13 @@
 #include "Engine/DataTable.h"
 #include "Weapon.generated.h"
 
+class AWeapon;
 class UTexture;
 class UWeaponSharedData;
+struct FStreamableHandle;
 
 DECLARE_MULTICAST_DELEGATE(FOnColMatCreated);
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FOnWeaponOwnerChanged, AWeapon* /*Weapon*/, AActor* /*OldOwner*/, AActor* /*NewOwner*/);
 
 USTRUCT(BlueprintType)
 struct SAUCEWICH_API FWeaponData : public FTableRowBase
@@ -49,6 +52,11 @@ public:
 	
 	AWeapon();
 
+	// 무기의 주인이 바뀔 때 호출됩니다. 리플리케이션 그래프가 무기를 주인 캐릭터에 묶는 데 씁니다.
+	static FOnWeaponOwnerChanged OnOwnerChanged;
+
+	void SetOwner(AActor* NewOwner) override;
+
 	UStaticMeshComponent* GetMesh() const { return Mesh; }
 	bool IsEquipped() const { return bEquipped; }
 
@@ -88,6 +96,9 @@ public:
 
 	void OnAvailabilityChanged(bool bAvailable) const;
 
+	// 이 무기가 사용하는 에셋들. CDO에서도 호출할 수 있습니다.
+	virtual void GetAssetsToLoad(TArray<FSoftObjectPath>& OutPaths) const {}
+
 protected:
 	void PostInitializeComponents() override;
 	void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
@@ -95,6 +106,10 @@ protected:
 	void OnActivated() override;
 	void OnReleased() override;
 
+	// 발사 등에 필요한 에셋을 비동기로 로드합니다. 무기가 지급되어 활성화될 때 호출됩니다.
+	void LoadAssets();
+	virtual void OnAssetsLoaded() {}
+
 private:
 	void Init();
 	UMaterialInstanceDynamic* GetMaterial() const;
@@ -113,6 +128,9 @@ private:
 	UPROPERTY(EditDefaultsOnly)
 	FDataTableRowHandle WeaponData;
 
+	// 풀에서 재사용되는 동안에도 같은 클래스이므로 한 번 로드한 에셋을 계속 붙잡아 둡니다.
+	TSharedPtr<FStreamableHandle> AssetsHandle;
+
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, ReplicatedUsing=OnRep_Equipped, Transient, meta=(AllowPrivateAccess=true))
 	uint8 bEquipped : 1;
 };
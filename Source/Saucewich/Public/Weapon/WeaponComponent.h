@@ -11,6 +11,49 @@ DECLARE_DYNAMIC_DELEGATE_OneParam(FOnEquipWeaponSingle, class AWeapon*, Weapon);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnWepAvailabilityChanged, bool, bAvailable);
 DECLARE_DYNAMIC_DELEGATE_OneParam(FOnWepAvailabilityChangedSingle, bool, bAvailable);
 
+/**
+ * 무기 입력 상태. 누르고 뗄 때마다 신뢰성 RPC를 보내는 대신 현재 상태를 통째로 보내므로,
+ * 중간에 패킷을 잃어도 다음 패킷으로 맞춰지고 신뢰성 버퍼가 막히지 않습니다.
+ */
+USTRUCT()
+struct FWeaponInputState
+{
+	GENERATED_BODY()
+
+	static constexpr auto MaxSlotBits = 9;
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	// Sequence를 빼고 비교합니다.
+	bool IsSameInput(const FWeaponInputState& Other) const
+	{
+		return bFire == Other.bFire && FireSeed == Other.FireSeed && Slots == Other.Slots;
+	}
+
+	bool IsIdle() const { return !bFire && Slots == 0; }
+
+	// 상태가 바뀔 때마다 1씩 늘어납니다. 서버는 이보다 오래된 상태를 버립니다.
+	UPROPERTY()
+	uint8 Sequence = 0;
+
+	UPROPERTY()
+	bool bFire = false;
+
+	// 발사를 시작할 때마다 새로 뽑는 탄퍼짐 시드. 발사 중에만 보냅니다.
+	UPROPERTY()
+	uint16 FireSeed = 0;
+
+	// 눌려 있는 슬롯 키 비트
+	UPROPERTY()
+	uint16 Slots = 0;
+};
+
+template <>
+struct TStructOpsTypeTraits<FWeaponInputState> : TStructOpsTypeTraitsBase2<FWeaponInputState>
+{
+	enum { WithNetSerializer = true };
+};
+
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class UWeaponComponent : public USceneComponent
 {
@@ -53,6 +96,12 @@ public:
 	UFUNCTION(BlueprintCallable) void FireP();
 	UFUNCTION(BlueprintCallable) void FireR();
 
+	// Saucewich.Net.InputStream이 켜져 있으면 무기 입력을 RPC 대신 FWeaponInputState로 주고받습니다.
+	static bool IsInputStreamEnabled();
+
+	// 마지막으로 발사를 시작할 때 쓴 탄퍼짐 시드
+	uint16 GetFireSeed() const { return FireSeed; }
+
 	struct FBroadcastEquipWeapon;
 	struct FBroadcastAvailabilityChanged;
 
@@ -65,6 +114,10 @@ protected:
 private:
 	void StartFire();
 	void StopFire();
+
+	// [Local] 자동 발사 여부를 정합니다. GunTrace는 정해진 주기마다, 또는 조준 상자 안의 가장 가까운 적이 바뀌면 바로 합니다.
+	bool SenseAutoFire(float DeltaTime);
+	void ResetAutoFire();
 	UFUNCTION(Server, Reliable, WithValidation) void ServerFireP();
 	UFUNCTION(Server, Reliable, WithValidation) void ServerFireR();
 	UFUNCTION(NetMulticast, Reliable) void MulticastFireP();
@@ -75,6 +128,18 @@ private:
 	UFUNCTION(NetMulticast, Reliable) void MulticastSlotP(uint8 Slot);
 	UFUNCTION(NetMulticast, Reliable) void MulticastSlotR(uint8 Slot);
 
+	UFUNCTION(Server, Unreliable, WithValidation)
+	void ServerSetInput(const FWeaponInputState& NewInput);
+
+	UFUNCTION()
+	void OnRep_Input(const FWeaponInputState& OldInput);
+
+	// [Local] 현재 입력 상태를 만들어 서버에 보내거나 (서버라면) 다른 클라이언트에 리플리케이트합니다.
+	void PublishInput(float DeltaTime);
+
+	// [Remote] 바뀐 입력 상태에 맞춰 키를 누르거나 뗍니다.
+	void ApplyInput(const FWeaponInputState& OldInput);
+
 	UFUNCTION()
 	void OnRep_Weapons();
 
@@ -92,8 +157,38 @@ private:
 	UPROPERTY(VisibleInstanceOnly, Replicated, Transient, BlueprintReadOnly, meta=(AllowPrivateAccess=true))
 	uint8 Active;
 
+	// 주인이 아닌 곳에서는 주인의 입력 상태, 주인에게서는 마지막으로 보낸 입력 상태입니다.
+	UPROPERTY(ReplicatedUsing=OnRep_Input, Transient)
+	FWeaponInputState Input;
+
+	float InputSendTime;
+	uint16 FireSeed;
+	uint16 HeldSlots;
+
+	// 보내기 전에 눌렀다 뗀 슬롯 키도 한 번은 보내지도록 모아 둡니다.
+	uint16 LatchedSlots;
+
+	// 상태가 바뀐 뒤 손실에 대비해 같은 상태를 더 보낼 횟수
+	uint8 RedundantSends;
+
+	// 서버가 마지막으로 받아서 적용한 입력 상태의 Sequence. 주인에게만 리플리케이트됩니다.
+	UPROPERTY(Replicated, Transient)
+	uint8 AckedSequence;
+
+	// 마지막으로 확인한 조준 상자 안의 가장 가까운 적. 바뀌었는지 비교하는 데만 씁니다.
+	const class ATpsCharacter* AutoFireCandidate;
+
+	float AutoFireSenseTime;
+
+	// 마지막으로 GunTrace가 적을 맞힌 뒤 지난 시간
+	float AutoFireHoldTime = MAX_flt;
+
+	// 후보가 바뀐 시각. 결정이 바뀌면 이 시각부터의 지연 시간을 통계로 남깁니다.
+	float AutoFireChangeTime = -1.f;
+
 	uint8 bFirePressed : 1;
 	uint8 bShouldAutoFire : 1;
+	uint8 bAutoFireHit : 1;
 	uint8 bFiring : 1;
 };
 
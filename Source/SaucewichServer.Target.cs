@@ -10,6 +10,7 @@ public class SaucewichServerTarget : TargetRules
 		Type = TargetType.Server;
 		bUseLoggingInShipping = true;
 		DefaultBuildSettings = BuildSettingsVersion.V2;
+		bWithPushModel = true;
 		ExtraModuleNames.AddRange( new string[] { "Saucewich" } );
 	}
 }